@@ -0,0 +1,17 @@
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Allocation counters of the benchmark.
+ *
+ * The benchmark replaces the global operator new, every allocation of the process goes through it, the path worker
+ * threads included. Scenarios read the counters before and after the measured code.
+ */
+
+extern std::atomic<uint64_t> allocationCount; /**< Number of calls to operator new so far. */
+extern std::atomic<uint64_t> allocatedBytes;  /**< Number of bytes requested from operator new so far. */
+
+#endif
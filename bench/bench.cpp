@@ -0,0 +1,431 @@
+#include "Allocations.h"
+#include "Game.h"
+#include "LevelScene.h"
+#include "LevelState.h"
+#include "Map.h"
+#include "utils.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Benchmark harness for the simulation, the pathfinding and the rendering.
+ *
+ * Every scenario loads a level, optionally fills it with units, and measures it on the headless game so results don't
+ * depend on a display. Rendering is measured last, only if a window can be created. The results are written as JSON to
+ * a file, the game itself logs to the standard output.
+ *
+ * Usage: lovetond_bench [--ticks N] [--units N] [--paths N] [--seed N] [--out file] [--no-render]
+ */
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Options of a benchmark run, set from the command line.
+   */
+  struct Options
+  {
+    int ticks = 600;
+    int units = 400;
+    int paths = 200;
+    unsigned int seed = 1;
+    std::string outPath = "bench_results.json";
+    bool render = true;
+  };
+
+  /**
+   * @brief Summary of a series of measurements in microseconds.
+   */
+  struct Stats
+  {
+    double mean = 0, p50 = 0, p95 = 0, p99 = 0, max = 0;
+  };
+
+  Stats summarize(std::vector<double> samples)
+  {
+    Stats stats;
+    if (samples.empty())
+      return stats;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double fraction)
+    {
+      return samples[std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()))];
+    };
+
+    double sum = 0;
+    for (double sample : samples)
+    {
+      sum += sample;
+    }
+    stats.mean = sum / samples.size();
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+  }
+
+  double microsecondsSince(Clock::time_point start)
+  {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  }
+
+  std::string toJson(const Stats &stats)
+  {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "{\"mean\": %.2f, \"p50\": %.2f, \"p95\": %.2f, \"p99\": %.2f, \"max\": %.2f}", stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+    return buffer;
+  }
+
+  /**
+   * @brief Reads the rows of a level file, without comments and empty lines, like LevelScene::loadLevel.
+   */
+  std::vector<std::string> readMapRows(const std::string &levelPath)
+  {
+    std::vector<std::string> rows;
+    std::ifstream levelFileStream(levelPath);
+    std::string line;
+    while (std::getline(levelFileStream, line))
+    {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (!line.empty() && line.substr(0, 2) != "//")
+        rows.push_back(line);
+    }
+    return rows;
+  }
+
+  /**
+   * @brief Stores a saved state with units for a scenario, LevelScene spawns them when the level is created.
+   *
+   * Units are placed on the free tiles inside an area of the map, one per tile while there are enough tiles. Once every
+   * tile is taken further units are stacked on the same tiles with a few pixels of offset, which is what the collision
+   * stress relies on. Owners and unit types alternate, so every player gets soldiers and workers.
+   *
+   * @param scenario The name of the scenario, used as the name of the level.
+   * @param rows The rows of the level file.
+   * @param count The number of units.
+   * @param area The area of the map in tiles to place the units in.
+   */
+  void saveUnits(const std::string &scenario, const std::vector<std::string> &rows, int count, SDL_Rect area)
+  {
+    std::vector<std::pair<int, int>> freeTiles;
+    int players = 1;
+    for (int y = 0; y < static_cast<int>(rows.size()); ++y)
+    {
+      for (int x = 0; x < static_cast<int>(rows[y].size()); ++x)
+      {
+        if (rows[y][x] == 'X' && (x == 0 || rows[y][x - 1] != 'X') && (y == 0 || rows[y - 1][x] != 'X'))
+          players++;
+        if (rows[y][x] == '.' && x >= area.x && x < area.x + area.w && y >= area.y && y < area.y + area.h)
+          freeTiles.push_back({x, y});
+      }
+    }
+
+    LevelState state;
+    state.levelName = scenario;
+    if (freeTiles.empty())
+    {
+      Game::save.saveLevelState(state);
+      return;
+    }
+
+    // Spread the units over the whole area instead of filling it from the top
+    size_t stride = std::max<size_t>(1, freeTiles.size() / std::max(count, 1));
+    for (int i = 0; i < count; ++i)
+    {
+      size_t slot = static_cast<size_t>(i) * stride;
+      const std::pair<int, int> &tile = freeTiles[slot % freeTiles.size()];
+      int offset = static_cast<int>(slot / freeTiles.size()) % 4 * 3;
+
+      LevelState::UnitInfo unit;
+      unit.ownerId = i % players;
+      unit.type = i % 3 == 0 ? WORKER : SOLDIER;
+      unit.health = getUnitStats(unit.type).health;
+      unit.coords = {tile.first * 16 + offset, 88 + tile.second * 16 + offset};
+      state.units.push_back(unit);
+    }
+    Game::save.saveLevelState(state);
+  }
+
+  /**
+   * @brief Runs a level for a number of ticks and measures every tick.
+   *
+   * @return std::string The JSON fields of the measurements.
+   */
+  std::string measureTicks(LevelScene &level, int ticks)
+  {
+    std::vector<double> tickTimes;
+    tickTimes.reserve(ticks);
+    uint64_t allocationsBefore = allocationCount.load();
+    uint64_t bytesBefore = allocatedBytes.load();
+    Arena &frameArena = LevelScene::getFrameArena();
+    size_t frameBlocksBefore = frameArena.getBlockAllocations();
+    size_t frameBytesPeak = 0;
+
+    Game::tick = 0;
+    for (int i = 0; i < ticks && !level.isGameOver(); ++i)
+    {
+      Clock::time_point start = Clock::now();
+      level.update();
+      tickTimes.push_back(microsecondsSince(start));
+      frameBytesPeak = std::max(frameBytesPeak, frameArena.getUsedBytes());
+      Game::tick++;
+    }
+
+    size_t measured = std::max<size_t>(1, tickTimes.size());
+    std::ostringstream json;
+    json << "\"ticks\": " << tickTimes.size()
+         << ", \"tick_us\": " << toJson(summarize(tickTimes))
+         << ", \"allocations_per_tick\": " << static_cast<double>(allocationCount.load() - allocationsBefore) / measured
+         << ", \"allocated_bytes_per_tick\": " << static_cast<double>(allocatedBytes.load() - bytesBefore) / measured
+         << ", \"frame_arena_peak_bytes\": " << frameBytesPeak
+         << ", \"frame_arena_blocks\": " << frameArena.getBlockAllocations() - frameBlocksBefore;
+    return json.str();
+  }
+
+  /**
+   * @brief Simulates a level filled with units, the scenarios of the simulation benchmarks.
+   */
+  std::string runSimulation(const std::string &scenario, const std::string &levelPath, int units, bool clustered, const Options &options)
+  {
+    std::vector<std::string> rows = readMapRows(levelPath);
+    if (rows.empty())
+    {
+      return "{\"name\": \"" + scenario + "\", \"error\": \"cannot read " + levelPath + "\"}";
+    }
+
+    int width = static_cast<int>(rows[0].size());
+    int height = static_cast<int>(rows.size());
+    // The collision stress packs all units into a 6x6 tile area in the middle of the map
+    SDL_Rect area = clustered ? SDL_Rect{width / 2 - 3, height / 2 - 3, 6, 6} : SDL_Rect{0, 0, width, height};
+    saveUnits(scenario, rows, units, area);
+
+    seedRandom(options.seed);
+    LevelScene level({scenario, levelPath});
+    if (!level.isLoaded())
+    {
+      return "{\"name\": \"" + scenario + "\", \"error\": \"cannot load " + levelPath + "\"}";
+    }
+
+    std::ostringstream json;
+    json << "{\"name\": \"" << scenario << "\", \"level\": \"" << levelPath << "\", \"units\": " << units << ", "
+         << measureTicks(level, options.ticks) << "}";
+    return json.str();
+  }
+
+  /**
+   * @brief Measures the longest path of a level with every pathfinding mode.
+   *
+   * The start is the first open tile of the map and the goal the open tile farthest from it by walking distance.
+   */
+  std::string runPathfinding(const std::string &scenario, const std::string &levelPath, const Options &options)
+  {
+    LevelState emptyState;
+    emptyState.levelName = scenario;
+    Game::save.saveLevelState(emptyState);
+
+    LevelScene level({scenario, levelPath});
+    if (!level.isLoaded())
+    {
+      return "{\"name\": \"" + scenario + "\", \"error\": \"cannot load " + levelPath + "\"}";
+    }
+    Map &map = LevelScene::getMap();
+
+    // Breadth first search from the first open tile, the last tile reached is the farthest one
+    std::pair<int, int> start{-1, -1};
+    for (int y = 0; y < map.getHeight() && start.first < 0; ++y)
+    {
+      for (int x = 0; x < map.getWidth() && start.first < 0; ++x)
+      {
+        if (map.isAccessible(x, y))
+          start = {x, y};
+      }
+    }
+    std::vector<int> visited(static_cast<size_t>(map.getWidth()) * map.getHeight(), 0);
+    std::queue<std::pair<int, int>> open;
+    std::pair<int, int> goal = start;
+    open.push(start);
+    visited[start.second * map.getWidth() + start.first] = 1;
+    while (!open.empty())
+    {
+      goal = open.front();
+      open.pop();
+      const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+      for (const auto &offset : offsets)
+      {
+        int x = goal.first + offset[0];
+        int y = goal.second + offset[1];
+        if (map.isAccessible(x, y) && !visited[y * map.getWidth() + x])
+        {
+          visited[y * map.getWidth() + x] = 1;
+          open.push({x, y});
+        }
+      }
+    }
+
+    PathfindingMode defaultMode = map.getPathfindingMode();
+    std::ostringstream json;
+    json << "{\"name\": \"" << scenario << "\", \"level\": \"" << levelPath << "\", \"start\": [" << start.first << ", " << start.second
+         << "], \"goal\": [" << goal.first << ", " << goal.second << "], \"modes\": [";
+
+    const std::pair<PathfindingMode, const char *> modes[] = {{ASTAR, "astar"}, {JUMP_POINT, "jump_point"}, {THETA_STAR, "theta_star"}};
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m)
+    {
+      map.setPathfindingMode(modes[m].first);
+      WaypointBuffer path;
+      map.calculatePath(start, goal, path); // Warm up, the first search allocates the search buffers
+
+      std::vector<double> pathTimes;
+      uint64_t allocationsBefore = allocationCount.load();
+      for (int i = 0; i < options.paths; ++i)
+      {
+        Clock::time_point begin = Clock::now();
+        map.calculatePath(start, goal, path);
+        pathTimes.push_back(microsecondsSince(begin));
+      }
+
+      // Every tile walked over moves the unit one tile along the longer axis of the segment
+      size_t pathLength = path.empty() ? 0 : 1;
+      for (size_t i = 1; i < path.size(); ++i)
+      {
+        pathLength += std::max(std::abs(path[i].first - path[i - 1].first), std::abs(path[i].second - path[i - 1].second));
+      }
+
+      json << (m ? ", " : "") << "{\"mode\": \"" << modes[m].second << "\", \"paths\": " << options.paths << ", \"path_tiles\": " << pathLength
+           << ", \"path_corners\": " << path.size()
+           << ", \"path_us\": " << toJson(summarize(pathTimes))
+           << ", \"allocations_per_path\": " << static_cast<double>(allocationCount.load() - allocationsBefore) / std::max(options.paths, 1) << "}";
+    }
+    map.setPathfindingMode(defaultMode);
+
+    json << "]}";
+    return json.str();
+  }
+
+  /**
+   * @brief Measures the rendering of a level filled with units, needs a display.
+   */
+  std::string runRendering(Game &game, const std::string &scenario, const std::string &levelPath, const Options &options)
+  {
+    Game::headless = false;
+    if (!game.init("Kingdom Clash benchmark", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, false))
+    {
+      return "{\"name\": \"" + scenario + "\", \"skipped\": \"no display\"}";
+    }
+
+    saveUnits(scenario, readMapRows(levelPath), options.units, SDL_Rect{0, 0, 1 << 16, 1 << 16});
+    seedRandom(options.seed);
+    LevelScene level({scenario, levelPath});
+    if (!level.isLoaded())
+    {
+      return "{\"name\": \"" + scenario + "\", \"error\": \"cannot load " + levelPath + "\"}";
+    }
+
+    std::vector<double> frameTimes;
+    Game::tick = 0;
+    for (int i = 0; i < options.ticks && !level.isGameOver(); ++i)
+    {
+      level.update();
+      Game::tick++;
+
+      Clock::time_point start = Clock::now();
+      SDL_RenderClear(Game::renderer);
+      level.render();
+      SDL_RenderPresent(Game::renderer);
+      frameTimes.push_back(microsecondsSince(start));
+    }
+
+    std::ostringstream json;
+    json << "{\"name\": \"" << scenario << "\", \"level\": \"" << levelPath << "\", \"units\": " << options.units
+         << ", \"frames\": " << frameTimes.size() << ", \"frame_us\": " << toJson(summarize(frameTimes)) << "}";
+    return json.str();
+  }
+
+  bool parseOptions(int argc, char *argv[], Options &options)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string argument = argv[i];
+      bool hasValue = i + 1 < argc;
+      try
+      {
+        if (argument == "--ticks" && hasValue)
+          options.ticks = std::stoi(argv[++i]);
+        else if (argument == "--units" && hasValue)
+          options.units = std::stoi(argv[++i]);
+        else if (argument == "--paths" && hasValue)
+          options.paths = std::stoi(argv[++i]);
+        else if (argument == "--seed" && hasValue)
+          options.seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument == "--out" && hasValue)
+          options.outPath = argv[++i];
+        else if (argument == "--no-render")
+          options.render = false;
+        else
+          return false;
+      }
+      catch (const std::exception &)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  if (!parseOptions(argc, argv, options))
+  {
+    std::cerr << "Usage: " << argv[0] << " [--ticks N] [--units N] [--paths N] [--seed N] [--out file] [--no-render]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Scenarios pass their units through saved level states, they must not end up in the player's save
+  std::filesystem::path savePath = std::filesystem::temp_directory_path() / "lovetond_bench_save.txt";
+  Game::save = Save(savePath.string());
+
+  Game game;
+  game.initHeadless();
+
+  std::vector<std::string> results;
+  results.push_back(runSimulation("units_level2", "./examples/maps/level2.txt", options.units, false, options));
+  results.push_back(runSimulation("collision_stress", "./examples/maps/level2.txt", options.units, true, options));
+  results.push_back(runSimulation("ai_eight_players", "./bench/maps/eight_players.txt", options.units, false, options));
+  results.push_back(runPathfinding("path_level1_worst", "./examples/maps/level1.txt", options));
+  if (options.render)
+  {
+    results.push_back(runRendering(game, "render_level1", "./examples/maps/level1.txt", options));
+  }
+
+  std::ostringstream json;
+  json << "{\n  \"seed\": " << options.seed << ",\n  \"ticks_per_second\": " << Game::ticksPerSecond << ",\n  \"scenarios\": [\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    json << "    " << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  json << "  ]\n}\n";
+
+  std::ofstream(options.outPath) << json.str();
+  std::cerr << "Benchmark results written to " << options.outPath << std::endl;
+
+  game.cleanup();
+  std::filesystem::remove(savePath);
+  return EXIT_SUCCESS;
+}
@@ -1,10 +1,13 @@
 #include "AI.h"
 #include "Game.h"
+#include "FlowField.h"
 #include "utils.h"
 #include "set"
+#include "Profiler.h"
+#include "Arena.h"
 #include <cmath>
 
-AI::AI(int x, int y, int id, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
+AI::AI(int x, int y, int id, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
     : allUnits(allUnits),
       allCastles(allCastles),
       allResources(allResources),
@@ -33,17 +36,12 @@ void AI::update()
   decideAction();
 }
 
-void AI::render()
-{
-  castle.render();
-}
-
 Castle &AI::getCastle()
 {
   return castle;
 }
 
-void AI::addUnit(int x, int y, const std::string &type, int health)
+void AI::addUnit(int x, int y, UnitType type, int health)
 {
   castle.spawnUnit(x, y, type, health);
 }
@@ -65,10 +63,16 @@ int AI::getId() const { return id; }
 
 void AI::decideAction()
 {
+  PROFILE_SCOPE("AI::decideAction");
 
-  std::vector<Unit *> ownedUnits;
-  std::vector<Unit *> ownedSoldiers;
-  std::vector<Unit *> ownedWorkers;
+  // Scratch lists of this tick, their memory is dropped when the frame arena is reset
+  ArenaAllocator<Unit *> frameAllocator(LevelScene::getFrameArena());
+  ArenaVector<Unit *> ownedUnits(frameAllocator);
+  ArenaVector<Unit *> ownedSoldiers(frameAllocator);
+  ArenaVector<Unit *> ownedWorkers(frameAllocator);
+  ownedUnits.reserve(allUnits.size());
+  ownedSoldiers.reserve(allUnits.size());
+  ownedWorkers.reserve(allUnits.size());
 
   int availableSoldiers = 0;
 
@@ -77,7 +81,7 @@ void AI::decideAction()
     if (unit->getOwnerId() == id && unit->isAlive())
     {
       ownedUnits.push_back(unit.get());
-      if (unit->getType() == "soldier")
+      if (unit->getType() == SOLDIER)
       {
         ownedSoldiers.push_back(unit.get());
         if (!unit->isMoving())
@@ -97,13 +101,15 @@ void AI::decideAction()
     int randomSoldierCount = randomInt(1, 3);
     int sent = 0;
 
+    std::shared_ptr<const FlowField> guardField = LevelScene::getMap().getFlowField(castle.getDamageFrom().first / 16, (castle.getDamageFrom().second - 88) / 16);
+
     for (auto &unit : ownedSoldiers)
     {
       if (!unit->isMoving())
       {
         sent++;
         availableSoldiers--;
-        unit->moveTo(castle.getDamageFrom().first, castle.getDamageFrom().second);
+        unit->followFlowField(*guardField);
         if (randomSoldierCount == sent)
           break;
       }
@@ -113,7 +119,7 @@ void AI::decideAction()
       for (auto &unit : ownedSoldiers)
       {
         sent++;
-        unit->moveTo(castle.getDamageFrom().first, castle.getDamageFrom().second);
+        unit->followFlowField(*guardField);
         if (randomSoldierCount == sent)
           break;
       }
@@ -163,10 +169,10 @@ void AI::decideAction()
           visited.insert(randomResourceIndex);
       }
 
-      std::pair<int, int> coords = pickRandomTileAround(*allResources[randomResourceIndex]);
+      Resource &targetedResource = *allResources[randomResourceIndex];
 
-      unit->moveTo(coords.first, coords.second);
-      printf("AI with ID %d is sending worker to mine at coords x: %d, y: %d\n", id, coords.first, coords.second);
+      unit->followFlowField(*getFlowFieldTo(targetedResource));
+      printf("AI with ID %d is sending worker to mine at coords x: %d, y: %d\n", id, targetedResource.getPosition().first, targetedResource.getPosition().second);
     }
   }
 
@@ -176,10 +182,10 @@ void AI::decideAction()
     bool found = false;
     for (auto &resource : allResources)
     {
-      found = checkAround(*resource, 2, false, "worker");
+      found = checkAround(*resource, 2, false, WORKER);
       if (found)
       {
-        std::pair<int, int> coords = getCoordOfUnitAround(*resource, 2, false, "worker");
+        std::pair<int, int> coords = getCoordOfUnitAround(*resource, 2, false, WORKER);
         for (auto &unit : ownedSoldiers)
         {
           if (!unit->isMoving())
@@ -213,7 +219,7 @@ void AI::decideAction()
 
       if (visited.size() == allCastles.size())
         break;
-      picked = (!checkAround(*allCastles[randomCastleIndex], 2, false, "soldier") && allCastles[randomCastleIndex]->getOwnerId() != id && allCastles[randomCastleIndex]->isAlive());
+      picked = (!checkAround(*allCastles[randomCastleIndex], 2, false, SOLDIER) && allCastles[randomCastleIndex]->getOwnerId() != id && allCastles[randomCastleIndex]->isAlive());
       if (!picked)
         visited.insert(randomCastleIndex);
     }
@@ -235,14 +241,19 @@ void AI::decideAction()
 
     int sentOut = 0;
 
+    // The whole army shares one flow field leading to the sides of the targeted castle
+    std::shared_ptr<const FlowField> armyField = targetedCastle ? getFlowFieldTo(*targetedCastle) : nullptr;
+
     for (auto &unit : ownedSoldiers)
     {
+      if (!armyField)
+        break;
+
       if (!unit->isMoving())
       {
         sentOut++;
         availableSoldiers--;
-        std::pair<int, int> coords = pickRandomTileAround(*targetedCastle);
-        unit->moveTo(coords.first, coords.second);
+        unit->followFlowField(*armyField);
         if (sentOut == neededUnitsForArmy)
         {
           printf("AI with ID %d is attacking castle with ID %d with an army of %d units\n", id, targetedCastle->getOwnerId(), neededUnitsForArmy);
@@ -260,95 +271,72 @@ void AI::decideAction()
   }
 }
 
-bool AI::checkAround(const GameObject &target, int tiles, bool friendly, std::string type)
+bool AI::checkAround(const GameObject &target, int tiles, bool friendly, std::optional<UnitType> type)
 {
 
-  int windowWidth, windowHeight;
-  SDL_GetWindowSize(Game::window, &windowWidth, &windowHeight);
+  // The search area is clamped to the map, which starts below the 88px menu bar
+  int mapRight = LevelScene::getMap().getWidth() * 16;
+  int mapBottom = 88 + LevelScene::getMap().getHeight() * 16;
 
   int leftX = std::max(target.getPosition().first - tiles * 16, 0);
-  int rightX = std::min(target.getPosition().first + target.getSize().first + tiles * 16, windowWidth);
+  int rightX = std::min(target.getPosition().first + target.getSize().first + tiles * 16, mapRight);
   int topY = std::max(target.getPosition().second - tiles * 16, 88);
-  int bottomY = std::min(target.getPosition().second + target.getSize().second + tiles * 16, windowHeight);
+  int bottomY = std::min(target.getPosition().second + target.getSize().second + tiles * 16, mapBottom);
 
   for (auto &unit : allUnits)
   {
     if (unit->getActualX() >= leftX && (unit->getActualX() + unit->getSize().first) <= rightX &&
         unit->getActualY() >= topY && (unit->getActualY() + unit->getSize().second) <= bottomY)
     {
-      if (type == "any")
-      {
-        if (unit->getOwnerId() == id && friendly && !unit->isMoving())
-          return true;
-        if (unit->getOwnerId() != id && !friendly && !unit->isMoving())
-          return true;
-      }
-
-      if (type == "soldier")
-      {
-        if (unit->getOwnerId() == id && friendly && !unit->isMoving() && unit->getType() == "soldier")
-          return true;
-        if (unit->getOwnerId() != id && !friendly && !unit->isMoving() && unit->getType() == "soldier")
-          return true;
-      }
+      if (type && unit->getType() != *type)
+        continue;
 
-      if (type == "worker")
-      {
-        if (unit->getOwnerId() == id && friendly && !unit->isMoving() && unit->getType() == "worker")
-          return true;
-        if (unit->getOwnerId() != id && !friendly && !unit->isMoving() && unit->getType() == "worker")
-          return true;
-      }
+      if (unit->getOwnerId() == id && friendly && !unit->isMoving())
+        return true;
+      if (unit->getOwnerId() != id && !friendly && !unit->isMoving())
+        return true;
     }
   }
 
   return false;
 }
 
-std::pair<int, int> AI::getCoordOfUnitAround(const GameObject &target, int tiles, bool friendly, std::string type)
+std::pair<int, int> AI::getCoordOfUnitAround(const GameObject &target, int tiles, bool friendly, std::optional<UnitType> type)
 {
-  int windowWidth, windowHeight;
-  SDL_GetWindowSize(Game::window, &windowWidth, &windowHeight);
+  int mapRight = LevelScene::getMap().getWidth() * 16;
+  int mapBottom = 88 + LevelScene::getMap().getHeight() * 16;
 
   int leftX = std::max(target.getPosition().first - tiles * 16, 0);
-  int rightX = std::min(target.getPosition().first + target.getSize().first + tiles * 16, windowWidth);
+  int rightX = std::min(target.getPosition().first + target.getSize().first + tiles * 16, mapRight);
   int topY = std::max(target.getPosition().second - tiles * 16, 88);
-  int bottomY = std::min(target.getPosition().second + target.getSize().second + tiles * 16, windowHeight);
+  int bottomY = std::min(target.getPosition().second + target.getSize().second + tiles * 16, mapBottom);
 
   for (auto &unit : allUnits)
   {
     if (unit->getActualX() >= leftX && (unit->getActualX() + unit->getSize().first) <= rightX &&
         unit->getActualY() >= topY && (unit->getActualY() + unit->getSize().second) <= bottomY)
     {
-      if (type == "any")
-      {
-        if (unit->getOwnerId() == id && friendly && !unit->isMoving())
-          return unit->getPosition();
-        if (unit->getOwnerId() != id && !friendly && !unit->isMoving())
-          return unit->getPosition();
-      }
-
-      if (type == "soldier")
-      {
-        if (unit->getOwnerId() == id && friendly && !unit->isMoving() && unit->getType() == "soldier")
-          return unit->getPosition();
-        if (unit->getOwnerId() != id && !friendly && !unit->isMoving() && unit->getType() == "soldier")
-          return unit->getPosition();
-      }
+      if (type && unit->getType() != *type)
+        continue;
 
-      if (type == "worker")
-      {
-        if (unit->getOwnerId() == id && friendly && !unit->isMoving() && unit->getType() == "worker")
-          return unit->getPosition();
-        if (unit->getOwnerId() != id && !friendly && !unit->isMoving() && unit->getType() == "worker")
-          return unit->getPosition();
-      }
+      if (unit->getOwnerId() == id && friendly && !unit->isMoving())
+        return unit->getPosition();
+      if (unit->getOwnerId() != id && !friendly && !unit->isMoving())
+        return unit->getPosition();
     }
   }
 
   return pickRandomTileAround(target);
 }
 
+std::shared_ptr<const FlowField> AI::getFlowFieldTo(const GameObject &target)
+{
+  std::pair<int, int> position = target.getPosition();
+  std::pair<int, int> size = target.getSize();
+
+  return LevelScene::getMap().getFlowField(position.first / 16, (position.second - 88) / 16, size.first / 16, size.second / 16);
+}
+
 std::pair<int, int> AI::pickRandomTileAround(const GameObject &target)
 {
   std::pair<int, int> position = target.getPosition();
@@ -7,6 +7,10 @@
 #include "TalentManager.h"
 #include "LevelState.h"
 #include <vector>
+#include <memory>
+#include <optional>
+
+class FlowField;
 
 /**
  * @class AI
@@ -33,7 +37,7 @@ public:
    * @param allResources Reference to all resources in the game.
    * @param allCastles Reference to all castles in the game.
    */
-  AI(int x, int y, int id, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
+  AI(int x, int y, int id, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
 
   /**
    * @brief Default destructor.
@@ -47,11 +51,6 @@ public:
    */
   void update();
 
-  /**
-   * @brief Renders the AI's castle.
-   */
-  void render();
-
   /**
    * @brief Return AI's castle
    *
@@ -67,7 +66,7 @@ public:
    * @param type Type of the unit to add
    * @param health Health of the unit to add
    */
-  void addUnit(int x, int y, const std::string &type, int health);
+  void addUnit(int x, int y, UnitType type, int health);
 
   /**
    * @brief Adds specified amount of crystals
@@ -112,7 +111,7 @@ public:
   int getId() const;
 
 private:
-  std::vector<Unit *> selectedUnits;
+  std::vector<UnitHandle> selectedUnits;
   std::vector<std::unique_ptr<Unit>> &allUnits;
   std::vector<Castle *> &allCastles;
   std::vector<std::unique_ptr<Resource>> &allResources;
@@ -148,11 +147,11 @@ private:
    * @param target The object to check tiles around
    * @param tiles The amount of tiles around the object to check (radius)
    * @param friendly If true, looks for friendly units. If false looks for enemy units
-   * @param type The type of unit to look for
+   * @param type The type of unit to look for, any type if empty
    * @return true If it found any unit in the radius
    * @return false If none units were found in the radius
    */
-  bool checkAround(const GameObject &target, int tiles, bool friendly, std::string type = "any");
+  bool checkAround(const GameObject &target, int tiles, bool friendly, std::optional<UnitType> type = std::nullopt);
 
   /**
    * @brief Gets the coordinates of unit around a object
@@ -160,10 +159,10 @@ private:
    * @param target The object to check tiles around
    * @param tiles The amount of tiles around the object to check (radius)
    * @param friendly If true, looks for friendly units. If false looks for enemy units
-   * @param type The type of unit to look for
+   * @param type The type of unit to look for, any type if empty
    * @return std::pair<int, int> The coordinates of found unit.
    */
-  std::pair<int, int> getCoordOfUnitAround(const GameObject &target, int tiles, bool friendly, std::string type);
+  std::pair<int, int> getCoordOfUnitAround(const GameObject &target, int tiles, bool friendly, std::optional<UnitType> type);
 
   /**
    * @brief Picks random tile around an object
@@ -172,6 +171,14 @@ private:
    * @return std::pair<int, int> Coordinates of the random tile
    */
   std::pair<int, int> pickRandomTileAround(const GameObject &target);
+
+  /**
+   * @brief Gets the shared flow field leading to the tiles around an object
+   *
+   * @param target The object units should gather around
+   * @return std::shared_ptr<const FlowField> The flow field leading to the sides of the object
+   */
+  std::shared_ptr<const FlowField> getFlowFieldTo(const GameObject &target);
 };
 
 #endif
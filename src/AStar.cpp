@@ -1,85 +1,153 @@
-#include "Game.h"
 #include "AStar.h"
-#include <set>
-#include <map>
+#include "Profiler.h"
 #include <algorithm>
-#include <stdexcept>
 #include <cmath>
-
-AStar::AStar(Map &map) : map(map) {}
-
-AStar::~AStar() = default;
+#include <cstdlib>
 
 /**
- * @brief Node structure for the AStar class.
- * Represents a node in the pathfinding graph, with x, y coordinates and g, h, f costs.
- * The 'cameFrom' shared pointer points to the previous node in the path.
+ * @brief Orders open list entries for the binary heap.
+ * Entries are compared by f value first and by coordinates on ties, so the heap top is the entry with the lowest f.
  */
-struct Node
+struct OpenEntryGreater
 {
-  int x, y;
-  float g, h, f;
-  std::shared_ptr<Node> cameFrom;
-
-  Node(int x, int y, std::shared_ptr<Node> cameFrom = nullptr) : x(x), y(y), g(std::numeric_limits<float>::infinity()), h(0), f(0), cameFrom(cameFrom) {}
-
-  // Compare nodes based on f value for set
-  bool operator<(const Node &other) const
+  template <typename Entry>
+  bool operator()(const Entry &a, const Entry &b) const
   {
-    if (f != other.f)
+    if (a.f != b.f)
     {
-      return f < other.f;
+      return a.f > b.f;
     }
-    if (x != other.x)
+    if (a.x != b.x)
     {
-      return x < other.x;
+      return a.x > b.x;
     }
-    return y < other.y;
+    return a.y > b.y;
   }
 };
 
-/**
- * @brief Functor for comparing nodes.
- * Used to compare nodes based on their f values in the open set of the AStar algorithm.
- */
-struct compareF
+AStar::AStar(const Map &map) : map(map), width(0), height(0), generation(0)
+{
+  prepare();
+}
+
+AStar::~AStar() = default;
+
+void AStar::prepare()
 {
-  bool operator()(const std::shared_ptr<Node> &a, const std::shared_ptr<Node> &b) const
+  if (width == map.getWidth() && height == map.getHeight())
   {
-    return *a < *b;
+    return;
   }
-};
+
+  width = map.getWidth();
+  height = map.getHeight();
+
+  size_t cellCount = static_cast<size_t>(width) * height;
+  gCost.assign(cellCount, 0.0f);
+  parent.assign(cellCount, -1);
+  openStamp.assign(cellCount, 0);
+  closedStamp.assign(cellCount, 0);
+  openList.clear();
+  openList.reserve(cellCount);
+  generation = 0;
+}
+
+void AStar::pushOpen(const OpenEntry &entry)
+{
+  openList.push_back(entry);
+  std::push_heap(openList.begin(), openList.end(), OpenEntryGreater());
+}
+
+AStar::OpenEntry AStar::popOpen()
+{
+  std::pop_heap(openList.begin(), openList.end(), OpenEntryGreater());
+  OpenEntry entry = openList.back();
+  openList.pop_back();
+  return entry;
+}
+
+void AStar::beginSearch()
+{
+  // Start a new generation, stamps from earlier searches become invalid
+  if (++generation == 0)
+  {
+    std::fill(openStamp.begin(), openStamp.end(), 0);
+    std::fill(closedStamp.begin(), closedStamp.end(), 0);
+    generation = 1;
+  }
+  openList.clear();
+}
+
+void AStar::reconstructPath(int goalIndex, std::vector<std::pair<int, int>> &path) const
+{
+  for (int index = goalIndex; index != -1; index = parent[index])
+  {
+    int x = index % width;
+    int y = index / width;
+    path.push_back({x, y});
+
+    if (parent[index] == -1)
+      break;
+
+    // Fill in the run towards the previous jump point, jumps only ever go straight or diagonally
+    int parentX = parent[index] % width;
+    int parentY = parent[index] / width;
+    int stepX = (parentX > x) - (parentX < x);
+    int stepY = (parentY > y) - (parentY < y);
+    for (x += stepX, y += stepY; x != parentX || y != parentY; x += stepX, y += stepY)
+    {
+      path.push_back({x, y});
+    }
+  }
+  std::reverse(path.begin(), path.end());
+}
 
 std::vector<std::pair<int, int>> AStar::getPath(int startX, int startY, int goalX, int goalY)
 {
-  std::set<std::shared_ptr<Node>, compareF> openSet;
-  std::map<std::pair<int, int>, std::shared_ptr<Node>> allNodes;
+  std::vector<std::pair<int, int>> path;
+  findPath(startX, startY, goalX, goalY, path);
+  return path;
+}
+
+bool AStar::findPath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>> &path)
+{
+  PROFILE_SCOPE("AStar::findPath");
+  path.clear();
+  prepare();
 
-  std::shared_ptr<Node> startNode = std::make_shared<Node>(startX, startY);
-  startNode->g = 0;
-  startNode->h = std::abs(goalX - startX) + std::abs(goalY - startY); // Manhatten distance
-  startNode->f = startNode->g + startNode->h;
+  if (startX < 0 || startX >= width || startY < 0 || startY >= height || !map.isAccessible(goalX, goalY))
+  {
+    return false;
+  }
 
-  allNodes[{startX, startY}] = startNode;
-  openSet.insert(startNode);
+  beginSearch();
+  const BitGrid &grid = map.getGrid();
 
-  while (!openSet.empty())
+  int startIndex = startY * width + startX;
+  gCost[startIndex] = 0;
+  parent[startIndex] = -1;
+  openStamp[startIndex] = generation;
+  pushOpen({static_cast<float>(std::abs(goalX - startX) + std::abs(goalY - startY)), 0.0f, startX, startY}); // Manhatten distance
+
+  while (!openList.empty())
   {
-    std::shared_ptr<Node> current = *openSet.begin();
-    openSet.erase(openSet.begin());
+    OpenEntry current = popOpen();
+    int currentIndex = current.y * width + current.x;
+
+    // Skip entries that were superseded by a cheaper route to the same cell
+    if (current.g != gCost[currentIndex] || closedStamp[currentIndex] == generation)
+      continue;
+    closedStamp[currentIndex] = generation;
 
-    if (current->x == goalX && current->y == goalY)
+    if (current.x == goalX && current.y == goalY)
     {
-      std::vector<std::pair<int, int>> path;
-      while (current)
-      {
-        path.push_back({current->x, current->y});
-        current = current->cameFrom;
-      }
-      std::reverse(path.begin(), path.end());
-      return path;
+      reconstructPath(currentIndex, path);
+      return true;
     }
 
+    // All eight neighbours and the corners between them in one lookup
+    uint32_t around = grid.neighbourhood(current.x, current.y);
+
     for (int dx = -1; dx <= 1; ++dx)
     {
       for (int dy = -1; dy <= 1; ++dy)
@@ -87,48 +155,365 @@ std::vector<std::pair<int, int>> AStar::getPath(int startX, int startY, int goal
         if (dx == 0 && dy == 0)
           continue;
 
-        int nextX = current->x + dx;
-        int nextY = current->y + dy;
+        int nextX = current.x + dx;
+        int nextY = current.y + dy;
 
         // Diagonal movement check
         if (dx != 0 && dy != 0)
         {
-          if (!map.isAccessible(current->x, current->y + dy) || !map.isAccessible(current->x + dx, current->y))
+          if (!(around & BitGrid::neighbour(0, dy)) || !(around & BitGrid::neighbour(dx, 0)))
           {
             continue;
           }
         }
 
-        if (map.isAccessible(nextX, nextY))
+        if (!(around & BitGrid::neighbour(dx, dy)))
+          continue;
+
+        int nextIndex = nextY * width + nextX;
+        float tentative_g = current.g + ((dx != 0 && dy != 0) ? static_cast<float>(M_SQRT2) : 1.0f);
+
+        if (openStamp[nextIndex] != generation || tentative_g < gCost[nextIndex])
         {
-          std::shared_ptr<Node> successor;
+          openStamp[nextIndex] = generation;
+          closedStamp[nextIndex] = 0;
+          gCost[nextIndex] = tentative_g;
+          parent[nextIndex] = currentIndex;
 
-          if (allNodes.count({nextX, nextY}))
-          {
-            successor = allNodes[{nextX, nextY}];
-          }
-          else
-          {
-            successor = std::make_shared<Node>(nextX, nextY, current);
-            allNodes[{nextX, nextY}] = successor;
-          }
+          float h = std::abs(goalX - nextX) + std::abs(goalY - nextY);
+          pushOpen({tentative_g + h, tentative_g, nextX, nextY});
+        }
+      }
+    }
+  }
 
-          float tentative_g = current->g + std::sqrt(dx * dx + dy * dy);
+  // No path found
+  return false;
+}
 
-          if (tentative_g < successor->g)
-          {
-            openSet.erase(successor);
-            successor->cameFrom = current;
-            successor->g = tentative_g;
-            successor->h = std::abs(goalX - nextX) + std::abs(goalY - nextY);
-            successor->f = successor->g + successor->h;
-            openSet.insert(successor);
-          }
+bool AStar::jump(int x, int y, int dx, int dy, int goalX, int goalY, int &jumpX, int &jumpY) const
+{
+  const BitGrid &grid = map.getGrid();
+
+  if (dy == 0)
+    return jumpHorizontal(x, y, dx, goalX, goalY, jumpX, jumpY);
+
+  while (true)
+  {
+    // Diagonal steps may not cut a blocked corner
+    if (dx != 0 && (!grid.get(x + dx, y) || !grid.get(x, y + dy)))
+      return false;
+
+    x += dx;
+    y += dy;
+
+    if (!grid.get(x, y))
+      return false;
+
+    if (x == goalX && y == goalY)
+      break;
+
+    if (dx != 0)
+    {
+      // A diagonal jump stops wherever one of its straight components finds a jump point
+      int unusedX, unusedY;
+      if (jumpHorizontal(x, y, dx, goalX, goalY, unusedX, unusedY) || jump(x, y, 0, dy, goalX, goalY, unusedX, unusedY))
+        break;
+    }
+    else
+    {
+      if ((grid.get(x - 1, y) && !grid.get(x - 1, y - dy)) || (grid.get(x + 1, y) && !grid.get(x + 1, y - dy)))
+        break;
+    }
+  }
+
+  jumpX = x;
+  jumpY = y;
+  return true;
+}
+
+bool AStar::jumpHorizontal(int x, int y, int dx, int goalX, int goalY, int &jumpX, int &jumpY) const
+{
+  const BitGrid &grid = map.getGrid();
+
+  // 64 tiles of a row starting at a tile, tiles left of the border read as blocked
+  auto span = [&grid](int first, int row)
+  {
+    return first >= -1 ? grid.row(first, row) : grid.row(-1, row) << (-1 - first);
+  };
+
+  // Every chunk stops at the first blocked tile, forced neighbour or the goal, the border guarantees a stop
+  for (int step = 0;; ++step)
+  {
+    uint64_t open, forced;
+    int first;
+    if (dx > 0)
+    {
+      first = x + 1 + step * 64;
+      open = span(first, y);
+      // A tile above or below opening up right after a blocked one is a forced neighbour
+      forced = (span(first, y - 1) & ~span(first - 1, y - 1)) | (span(first, y + 1) & ~span(first - 1, y + 1));
+    }
+    else
+    {
+      first = x - 64 - step * 64;
+      open = span(first, y);
+      forced = (span(first, y - 1) & ~span(first + 1, y - 1)) | (span(first, y + 1) & ~span(first + 1, y + 1));
+    }
+
+    uint64_t stops = ~open | forced;
+    if (goalY == y && goalX >= first && goalX < first + 64)
+    {
+      stops |= uint64_t(1) << (goalX - first);
+    }
+
+    if (stops != 0)
+    {
+      int offset = dx > 0 ? __builtin_ctzll(stops) : 63 - __builtin_clzll(stops);
+      if (!((open >> offset) & 1))
+        return false;
+
+      jumpX = first + offset;
+      jumpY = y;
+      return true;
+    }
+  }
+}
+
+bool AStar::findJumpPointPath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>> &path)
+{
+  PROFILE_SCOPE("AStar::findJumpPointPath");
+  path.clear();
+  prepare();
+
+  if (startX < 0 || startX >= width || startY < 0 || startY >= height || !map.isAccessible(goalX, goalY))
+  {
+    return false;
+  }
+
+  beginSearch();
+  const BitGrid &grid = map.getGrid();
+
+  // Octile distance, admissible for 8 directional movement with diagonal cost sqrt(2)
+  auto heuristic = [](int fromX, int fromY, int toX, int toY)
+  {
+    int dx = std::abs(toX - fromX);
+    int dy = std::abs(toY - fromY);
+    return static_cast<float>(dx + dy) + static_cast<float>(M_SQRT2 - 2.0) * std::min(dx, dy);
+  };
+
+  int startIndex = startY * width + startX;
+  gCost[startIndex] = 0;
+  parent[startIndex] = -1;
+  openStamp[startIndex] = generation;
+  pushOpen({heuristic(startX, startY, goalX, goalY), 0.0f, startX, startY});
+
+  while (!openList.empty())
+  {
+    OpenEntry current = popOpen();
+    int currentIndex = current.y * width + current.x;
+
+    if (current.g != gCost[currentIndex] || closedStamp[currentIndex] == generation)
+      continue;
+    closedStamp[currentIndex] = generation;
+
+    if (current.x == goalX && current.y == goalY)
+    {
+      reconstructPath(currentIndex, path);
+      return true;
+    }
+
+    // Collect the directions worth jumping in, pruned by the direction we arrived from
+    int directions[8][2];
+    int directionCount = 0;
+    auto addDirection = [&directions, &directionCount](int dx, int dy)
+    {
+      directions[directionCount][0] = dx;
+      directions[directionCount][1] = dy;
+      directionCount++;
+    };
+
+    if (parent[currentIndex] == -1)
+    {
+      for (int dx = -1; dx <= 1; ++dx)
+      {
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+          if (dx != 0 || dy != 0)
+            addDirection(dx, dy);
+        }
+      }
+    }
+    else
+    {
+      int parentX = parent[currentIndex] % width;
+      int parentY = parent[currentIndex] / width;
+      int dx = (current.x > parentX) - (current.x < parentX);
+      int dy = (current.y > parentY) - (current.y < parentY);
+
+      if (dx != 0 && dy != 0)
+      {
+        bool verticalOpen = grid.get(current.x, current.y + dy);
+        bool horizontalOpen = grid.get(current.x + dx, current.y);
+        if (verticalOpen)
+          addDirection(0, dy);
+        if (horizontalOpen)
+          addDirection(dx, 0);
+        if (verticalOpen && horizontalOpen)
+          addDirection(dx, dy);
+      }
+      else if (dx != 0)
+      {
+        bool nextOpen = grid.get(current.x + dx, current.y);
+        bool belowOpen = grid.get(current.x, current.y + 1);
+        bool aboveOpen = grid.get(current.x, current.y - 1);
+        if (nextOpen)
+        {
+          addDirection(dx, 0);
+          if (belowOpen)
+            addDirection(dx, 1);
+          if (aboveOpen)
+            addDirection(dx, -1);
+        }
+        if (belowOpen)
+          addDirection(0, 1);
+        if (aboveOpen)
+          addDirection(0, -1);
+      }
+      else
+      {
+        bool nextOpen = grid.get(current.x, current.y + dy);
+        bool rightOpen = grid.get(current.x + 1, current.y);
+        bool leftOpen = grid.get(current.x - 1, current.y);
+        if (nextOpen)
+        {
+          addDirection(0, dy);
+          if (rightOpen)
+            addDirection(1, dy);
+          if (leftOpen)
+            addDirection(-1, dy);
+        }
+        if (rightOpen)
+          addDirection(1, 0);
+        if (leftOpen)
+          addDirection(-1, 0);
+      }
+    }
+
+    for (int i = 0; i < directionCount; ++i)
+    {
+      int jumpX, jumpY;
+      if (!jump(current.x, current.y, directions[i][0], directions[i][1], goalX, goalY, jumpX, jumpY))
+        continue;
+
+      int jumpIndex = jumpY * width + jumpX;
+      float tentative_g = current.g + heuristic(current.x, current.y, jumpX, jumpY);
+
+      if (openStamp[jumpIndex] != generation || tentative_g < gCost[jumpIndex])
+      {
+        openStamp[jumpIndex] = generation;
+        closedStamp[jumpIndex] = 0;
+        gCost[jumpIndex] = tentative_g;
+        parent[jumpIndex] = currentIndex;
+        pushOpen({tentative_g + heuristic(jumpX, jumpY, goalX, goalY), tentative_g, jumpX, jumpY});
+      }
+    }
+  }
+
+  // No path found
+  return false;
+}
+
+bool AStar::findThetaStarPath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>> &path)
+{
+  PROFILE_SCOPE("AStar::findThetaStarPath");
+  path.clear();
+  prepare();
+
+  if (startX < 0 || startX >= width || startY < 0 || startY >= height || !map.isAccessible(goalX, goalY))
+  {
+    return false;
+  }
+
+  beginSearch();
+  const BitGrid &grid = map.getGrid();
+
+  // Straight line distance, links are no longer bound to the grid directions
+  auto distance = [](int fromX, int fromY, int toX, int toY)
+  {
+    return static_cast<float>(std::hypot(toX - fromX, toY - fromY));
+  };
+
+  int startIndex = startY * width + startX;
+  gCost[startIndex] = 0;
+  parent[startIndex] = -1;
+  openStamp[startIndex] = generation;
+  pushOpen({distance(startX, startY, goalX, goalY), 0.0f, startX, startY});
+
+  while (!openList.empty())
+  {
+    OpenEntry current = popOpen();
+    int currentIndex = current.y * width + current.x;
+
+    if (current.g != gCost[currentIndex] || closedStamp[currentIndex] == generation)
+      continue;
+    closedStamp[currentIndex] = generation;
+
+    if (current.x == goalX && current.y == goalY)
+    {
+      // Only the turning points are linked, there are no runs to fill in
+      for (int index = currentIndex; index != -1; index = parent[index])
+      {
+        path.push_back({index % width, index / width});
+      }
+      std::reverse(path.begin(), path.end());
+      return true;
+    }
+
+    int parentIndex = parent[currentIndex];
+    int parentX = parentIndex % width;
+    int parentY = parentIndex / width;
+    uint32_t around = grid.neighbourhood(current.x, current.y);
+
+    for (int dx = -1; dx <= 1; ++dx)
+    {
+      for (int dy = -1; dy <= 1; ++dy)
+      {
+        if (dx == 0 && dy == 0)
+          continue;
+
+        if (dx != 0 && dy != 0 && (!(around & BitGrid::neighbour(0, dy)) || !(around & BitGrid::neighbour(dx, 0))))
+          continue;
+
+        if (!(around & BitGrid::neighbour(dx, dy)))
+          continue;
+
+        int nextX = current.x + dx;
+        int nextY = current.y + dy;
+        int nextIndex = nextY * width + nextX;
+        if (closedStamp[nextIndex] == generation)
+          continue;
+
+        // Skip the expanded cell when its parent can see the neighbour
+        int linkIndex = currentIndex;
+        float tentative_g = current.g + ((dx != 0 && dy != 0) ? static_cast<float>(M_SQRT2) : 1.0f);
+        if (parentIndex != -1 && map.hasLineOfSight(parentX, parentY, nextX, nextY))
+        {
+          linkIndex = parentIndex;
+          tentative_g = gCost[parentIndex] + distance(parentX, parentY, nextX, nextY);
+        }
+
+        if (openStamp[nextIndex] != generation || tentative_g < gCost[nextIndex])
+        {
+          openStamp[nextIndex] = generation;
+          gCost[nextIndex] = tentative_g;
+          parent[nextIndex] = linkIndex;
+          pushOpen({tentative_g + distance(nextX, nextY, goalX, goalY), tentative_g, nextX, nextY});
         }
       }
     }
   }
 
   // No path found
-  return {};
+  return false;
 }
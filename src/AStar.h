@@ -4,6 +4,7 @@
 #include "Map.h"
 #include <vector>
 #include <utility>
+#include <cstdint>
 
 /**
  * @class AStar
@@ -11,16 +12,26 @@
  *
  * The AStar class is responsible for finding the shortest path between two points on a game map using the A* algorithm.
  * It takes into account the obstacles and terrain of the map to determine the most optimal path.
+ *
+ * The search works on flat arrays indexed by grid cell (g-cost, parent index and generation stamps) and a binary heap
+ * as the open list. All buffers are sized to the map once and reused by every following search, so a search does not
+ * allocate unless the map grows. Generation stamps mark which cells belong to the current search, which makes
+ * resetting the buffers between searches free.
+ *
+ * Besides plain A*, the same buffers back a Jump Point Search. JPS only pushes jump points onto the open list and
+ * skips the symmetric cells in between, which removes most of the open list work on open fields of uniform-cost maps.
+ * They also back Theta*, which lets a cell take the parent of its parent when the map has a line of sight between
+ * them, so the path may leave the 8 grid directions.
  */
 class AStar
 {
 public:
   /**
    * @brief Constructor for the AStar class.
-   * Initializes the AStar object with a reference to the game map.
+   * Initializes the AStar object with a reference to the game map and sizes the search buffers to its grid.
    * @param map The game map to be used for pathfinding.
    */
-  AStar(Map &map);
+  AStar(const Map &map);
 
   /**
    * @brief Destructor for the AStar class.
@@ -41,8 +52,121 @@ public:
    */
   std::vector<std::pair<int, int>> getPath(int startX, int startY, int goalX, int goalY);
 
+  /**
+   * @brief Finds a path from one point to another and writes it into a caller owned buffer.
+   * Same search as getPath, but the buffer is cleared and reused so repeated calls do not allocate.
+   * @param startX The x coordinate of the start position.
+   * @param startY The y coordinate of the start position.
+   * @param goalX The x coordinate of the goal position.
+   * @param goalY The y coordinate of the goal position.
+   * @param path Output buffer for the path from the start to the goal. Left empty if no path is found.
+   * @return True if a path was found, false otherwise.
+   */
+  bool findPath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>> &path);
+
+  /**
+   * @brief Finds a path from one point to another using Jump Point Search.
+   * Follows the same movement rules as findPath (8 directions, no cutting of blocked corners) and returns the path in
+   * the same tile by tile format, the straight runs between jump points are filled in before returning.
+   * @param startX The x coordinate of the start position.
+   * @param startY The y coordinate of the start position.
+   * @param goalX The x coordinate of the goal position.
+   * @param goalY The y coordinate of the goal position.
+   * @param path Output buffer for the path from the start to the goal. Left empty if no path is found.
+   * @return True if a path was found, false otherwise.
+   */
+  bool findJumpPointPath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>> &path);
+
+  /**
+   * @brief Finds an any-angle path from one point to another using Theta*.
+   * Expands the same neighbours as findPath, but links a cell straight to the parent of the expanded cell whenever
+   * Map::hasLineOfSight allows it. The path only holds the cells where it turns, consecutive cells are not adjacent.
+   * @param startX The x coordinate of the start position.
+   * @param startY The y coordinate of the start position.
+   * @param goalX The x coordinate of the goal position.
+   * @param goalY The y coordinate of the goal position.
+   * @param path Output buffer for the turning points from the start to the goal. Left empty if no path is found.
+   * @return True if a path was found, false otherwise.
+   */
+  bool findThetaStarPath(int startX, int startY, int goalX, int goalY, std::vector<std::pair<int, int>> &path);
+
 private:
-  Map &map;
+  /**
+   * @brief Entry of the open list heap.
+   * Carries the f and g costs the cell had when it was pushed, so outdated entries can be skipped when popped.
+   */
+  struct OpenEntry
+  {
+    float f, g;
+    int x, y;
+  };
+
+  /**
+   * @brief Resizes the search buffers if the map grid changed size since the last search.
+   */
+  void prepare();
+
+  /**
+   * @brief Pushes a cell onto the open list heap.
+   * @param entry The open list entry to push.
+   */
+  void pushOpen(const OpenEntry &entry);
+
+  /**
+   * @brief Pops the entry with the lowest f cost from the open list heap.
+   * @return The entry with the lowest f cost.
+   */
+  OpenEntry popOpen();
+
+  /**
+   * @brief Starts a new search by advancing the generation stamp and clearing the open list.
+   */
+  void beginSearch();
+
+  /**
+   * @brief Walks the parent indexes back from the goal and writes the path into the buffer.
+   * Consecutive cells that are not adjacent (jump points) are connected by the straight or diagonal run between them.
+   * @param goalIndex The grid index of the goal cell.
+   * @param path Output buffer for the path from the start to the goal.
+   */
+  void reconstructPath(int goalIndex, std::vector<std::pair<int, int>> &path) const;
+
+  /**
+   * @brief Moves from a cell in one direction until a jump point, the goal or an obstacle is reached.
+   * @param x The x coordinate of the cell the jump starts from.
+   * @param y The y coordinate of the cell the jump starts from.
+   * @param dx The x direction of the jump (-1, 0 or 1).
+   * @param dy The y direction of the jump (-1, 0 or 1).
+   * @param goalX The x coordinate of the goal position.
+   * @param goalY The y coordinate of the goal position.
+   * @param jumpX Set to the x coordinate of the found jump point.
+   * @param jumpY Set to the y coordinate of the found jump point.
+   * @return True if a jump point was found, false if the jump ran into an obstacle.
+   */
+  bool jump(int x, int y, int dx, int dy, int goalX, int goalY, int &jumpX, int &jumpY) const;
+
+  /**
+   * @brief Horizontal case of jump, scans the row 64 tiles at a time using the row spans of the map grid.
+   * @param x The x coordinate of the cell the jump starts from.
+   * @param y The y coordinate of the cell the jump starts from.
+   * @param dx The x direction of the jump (-1 or 1).
+   * @param goalX The x coordinate of the goal position.
+   * @param goalY The y coordinate of the goal position.
+   * @param jumpX Set to the x coordinate of the found jump point.
+   * @param jumpY Set to the y coordinate of the found jump point.
+   * @return True if a jump point was found, false if the jump ran into an obstacle.
+   */
+  bool jumpHorizontal(int x, int y, int dx, int goalX, int goalY, int &jumpX, int &jumpY) const;
+
+  const Map &map;
+  int width, height;
+
+  std::vector<float> gCost;
+  std::vector<int> parent;
+  std::vector<uint32_t> openStamp;
+  std::vector<uint32_t> closedStamp;
+  std::vector<OpenEntry> openList;
+  uint32_t generation;
 };
 
 #endif
@@ -0,0 +1,77 @@
+#include "Arena.h"
+#include <algorithm>
+
+Arena::Arena(size_t blockSize)
+    : blockSize(blockSize), currentBlock(0), offset(0), usedBytes(0), blockAllocations(0), freeObjects()
+{
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+  while (true)
+  {
+    if (currentBlock < blocks.size())
+    {
+      Block &block = blocks[currentBlock];
+      size_t start = (offset + alignment - 1) & ~(alignment - 1);
+      if (start + size <= block.size)
+      {
+        offset = start + size;
+        usedBytes += size;
+        return block.memory.get() + start;
+      }
+
+      // The rest of the block is wasted until the next reset
+      ++currentBlock;
+      offset = 0;
+      continue;
+    }
+
+    size_t newBlockSize = std::max(blockSize, size);
+    blocks.push_back({std::unique_ptr<char[]>(new char[newBlockSize]), newBlockSize});
+    ++blockAllocations;
+  }
+}
+
+void Arena::reset()
+{
+  currentBlock = 0;
+  offset = 0;
+  usedBytes = 0;
+  std::fill(std::begin(freeObjects), std::end(freeObjects), nullptr);
+}
+
+void *Arena::allocateObject(size_t size)
+{
+  size_t sizeClass = (size + sizeof(ObjectHeader) - 1) / sizeof(ObjectHeader) + 1;
+
+  ObjectHeader *header;
+  if (sizeClass < sizeClasses && freeObjects[sizeClass] != nullptr)
+  {
+    header = freeObjects[sizeClass];
+    freeObjects[sizeClass] = header->next;
+  }
+  else
+  {
+    // Objects too big for the free lists are never reused, there are none in the game
+    header = static_cast<ObjectHeader *>(allocate(sizeClass * sizeof(ObjectHeader), alignof(ObjectHeader)));
+  }
+
+  header->owner = this;
+  header->sizeClass = sizeClass;
+  return header + 1;
+}
+
+void Arena::freeObject(void *memory)
+{
+  if (memory == nullptr)
+    return;
+
+  ObjectHeader *header = static_cast<ObjectHeader *>(memory) - 1;
+  Arena *owner = header->owner;
+  if (header->sizeClass < sizeClasses)
+  {
+    header->next = owner->freeObjects[header->sizeClass];
+    owner->freeObjects[header->sizeClass] = header;
+  }
+}
@@ -0,0 +1,154 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class Arena
+ * @brief Bump allocator handing out memory from a few large blocks.
+ *
+ * Memory is only given back all at once, by reset or when the arena is destroyed. The blocks are kept over a reset, so
+ * an arena that is reset every tick stops asking the global allocator for memory once its blocks are big enough.
+ *
+ * On top of that the arena pools objects that die one by one (units): freed objects are kept on a free list per size
+ * and reused by the next object of the same size. Arenas are not thread safe, they are used on the main thread only.
+ */
+class Arena
+{
+public:
+  /**
+   * @brief Creates an empty arena, no memory is allocated until it is needed.
+   *
+   * @param blockSize The size of the blocks requested from the global allocator, bigger allocations get their own block.
+   */
+  explicit Arena(size_t blockSize = 64 * 1024);
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Allocates memory that stays valid until the arena is reset or destroyed.
+   *
+   * @param size The size of the memory in bytes.
+   * @param alignment The alignment of the memory, at most alignof(std::max_align_t).
+   * @return void* The memory.
+   */
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @brief Makes all memory of the arena available again, without freeing its blocks.
+   *
+   * Pooled objects must not be alive anymore, their free lists are dropped too.
+   */
+  void reset();
+
+  /**
+   * @brief Allocates memory for an object that is freed on its own, reusing the memory of a freed object of the same size.
+   *
+   * @param size The size of the object in bytes.
+   * @return void* The memory, aligned like memory from operator new.
+   */
+  void *allocateObject(size_t size);
+
+  /**
+   * @brief Gives the memory of an object back to the arena it came from.
+   *
+   * @param memory Memory returned by allocateObject of any arena.
+   */
+  static void freeObject(void *memory);
+
+  /**
+   * @brief Returns the number of bytes allocated since the last reset.
+   *
+   * @return size_t The number of bytes, without padding.
+   */
+  size_t getUsedBytes() const { return usedBytes; }
+
+  /**
+   * @brief Returns how often the arena asked the global allocator for a block since it was created.
+   *
+   * @return size_t The number of blocks allocated.
+   */
+  size_t getBlockAllocations() const { return blockAllocations; }
+
+private:
+  /**
+   * @struct Block
+   * @brief A block of memory the arena hands out from.
+   */
+  struct Block
+  {
+    std::unique_ptr<char[]> memory;
+    size_t size;
+  };
+
+  /**
+   * @struct ObjectHeader
+   * @brief Stored in front of every pooled object.
+   */
+  struct alignas(std::max_align_t) ObjectHeader
+  {
+    union
+    {
+      Arena *owner;       /**< The arena of the object while it is alive. */
+      ObjectHeader *next; /**< The next free object of the same size while it is free. */
+    };
+    size_t sizeClass; /**< The size of the object with its header in multiples of the header size. */
+  };
+
+  static const size_t sizeClasses = 64;
+
+  size_t blockSize;
+  std::vector<Block> blocks;
+  size_t currentBlock;
+  size_t offset;
+  size_t usedBytes;
+  size_t blockAllocations;
+  ObjectHeader *freeObjects[sizeClasses];
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Standard allocator taking memory from an arena, memory is never given back before the arena is reset.
+ *
+ * @tparam T The type of the allocated objects.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  /**
+   * @brief Creates an allocator taking memory from an arena.
+   *
+   * @param arena The arena, it has to outlive the allocator and all memory allocated from it.
+   */
+  explicit ArenaAllocator(Arena &arena) : arena(&arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+  T *allocate(size_t count) { return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T))); }
+
+  void deallocate(T *, size_t) {}
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+  Arena *arena;
+};
+
+/**
+ * @brief A vector in an arena, for scratch data that lives until the arena is reset.
+ */
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
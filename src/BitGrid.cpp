@@ -0,0 +1,32 @@
+#include "BitGrid.h"
+
+BitGrid::BitGrid() : width(0), height(0), stride(0) {}
+
+void BitGrid::reset(int width, int height)
+{
+  this->width = width;
+  this->height = height;
+
+  // One border tile on each side, rounded up to whole words, plus a spare word read by row spans near the end
+  stride = (width + 2 + 63) / 64 + 1;
+  bits.assign(static_cast<size_t>(stride) * (height + 2), 0);
+}
+
+void BitGrid::set(int x, int y, bool open)
+{
+  int column = x + 1;
+  uint64_t &word = bits[(y + 1) * stride + (column >> 6)];
+  uint64_t mask = uint64_t(1) << (column & 63);
+  if (open)
+  {
+    word |= mask;
+  }
+  else
+  {
+    word &= ~mask;
+  }
+}
+
+int BitGrid::getWidth() const { return width; }
+
+int BitGrid::getHeight() const { return height; }
@@ -0,0 +1,116 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class BitGrid
+ * @brief Compact walkability grid stored as one contiguous bitset.
+ *
+ * Every tile takes one bit, set if the tile is open. The grid is surrounded by a one tile border of blocked tiles, so
+ * any tile up to one step outside the map can be read without a bounds check. Each row is padded to whole 64 bit
+ * words plus one spare word, which lets a span of 64 tiles starting anywhere in a row be read with two word loads.
+ *
+ * Besides single tile lookups, the grid answers word level queries used by the pathfinders: the 3x3 neighbourhood of
+ * a tile as a bit mask and a span of 64 tiles of a row.
+ */
+class BitGrid
+{
+public:
+  /**
+   * @brief Constructs an empty grid.
+   */
+  BitGrid();
+
+  /**
+   * @brief Resizes the grid and marks every tile as blocked.
+   *
+   * @param width The width of the grid in tiles.
+   * @param height The height of the grid in tiles.
+   */
+  void reset(int width, int height);
+
+  /**
+   * @brief Marks a tile as open or blocked.
+   *
+   * @param x The x-coordinate of the tile, within the grid.
+   * @param y The y-coordinate of the tile, within the grid.
+   * @param open True if the tile is open, false if it is blocked.
+   */
+  void set(int x, int y, bool open);
+
+  /**
+   * @brief Checks whether a tile is open.
+   *
+   * @param x The x-coordinate of the tile, from -1 to width.
+   * @param y The y-coordinate of the tile, from -1 to height.
+   * @return bool True if the tile is open, false otherwise. Tiles of the border are always blocked.
+   */
+  bool get(int x, int y) const
+  {
+    int column = x + 1;
+    return (bits[(y + 1) * stride + (column >> 6)] >> (column & 63)) & 1;
+  }
+
+  /**
+   * @brief Returns 64 tiles of a row starting at a tile.
+   *
+   * @param x The x-coordinate of the first tile, from -1 to width.
+   * @param y The y-coordinate of the row, from -1 to height.
+   * @return uint64_t Bit i is set if tile (x + i, y) is open, tiles past the border read as blocked.
+   */
+  uint64_t row(int x, int y) const
+  {
+    int column = x + 1;
+    const uint64_t *word = &bits[(y + 1) * stride + (column >> 6)];
+    int shift = column & 63;
+    return shift == 0 ? word[0] : (word[0] >> shift) | (word[1] << (64 - shift));
+  }
+
+  /**
+   * @brief Returns the 3x3 neighbourhood of a tile as a bit mask.
+   *
+   * Bit (dy + 1) * 3 + (dx + 1) is set if tile (x + dx, y + dy) is open, see the neighbour function.
+   *
+   * @param x The x-coordinate of the tile, within the grid.
+   * @param y The y-coordinate of the tile, within the grid.
+   * @return uint32_t The 9 bit neighbourhood mask.
+   */
+  uint32_t neighbourhood(int x, int y) const
+  {
+    return (row(x - 1, y - 1) & 7) | ((row(x - 1, y) & 7) << 3) | ((row(x - 1, y + 1) & 7) << 6);
+  }
+
+  /**
+   * @brief Returns the bit of a neighbour in a neighbourhood mask.
+   *
+   * @param dx The x offset of the neighbour (-1, 0 or 1).
+   * @param dy The y offset of the neighbour (-1, 0 or 1).
+   * @return uint32_t The bit of the neighbour.
+   */
+  static uint32_t neighbour(int dx, int dy) { return 1u << ((dy + 1) * 3 + (dx + 1)); }
+
+  /**
+   * @brief Returns the width of the grid in tiles.
+   *
+   * @return int The width without the border.
+   */
+  int getWidth() const;
+
+  /**
+   * @brief Returns the height of the grid in tiles.
+   *
+   * @return int The height without the border.
+   */
+  int getHeight() const;
+
+private:
+  int width;
+  int height;
+  int stride;
+  std::vector<uint64_t> bits;
+};
+
+#endif
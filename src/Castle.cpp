@@ -3,7 +3,7 @@
 #include "Worker.h"
 #include "utils.h"
 
-Castle::Castle(int x, int y, int width, int height, int ownerId, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles, float &speedMultiplier, float &healthMultiplier, float &spawnRateMultiplier, float &hasteMultiplier, int &baseAttackDamage, uint32_t &baseAttackSpeed, uint32_t &gatherRate, int &wood, int &crystals, uint32_t &spawnInterval)
+Castle::Castle(int x, int y, int width, int height, int ownerId, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles, float &speedMultiplier, float &healthMultiplier, float &spawnRateMultiplier, float &hasteMultiplier, int &baseAttackDamage, uint32_t &baseAttackSpeed, uint32_t &gatherRate, int &wood, int &crystals, uint32_t &spawnInterval)
     : GameObject(x, y, width, height),
       maxHealth(250),
       health(250),
@@ -23,7 +23,7 @@ Castle::Castle(int x, int y, int width, int height, int ownerId, std::vector<std
       wood(wood),
       crystals(crystals),
       spawnInterval(spawnInterval),
-      lastSpawnTime(SDL_GetTicks()),
+      lastSpawnTick(Game::tick),
       damageFrom({-1, -1})
 {
   setTexture(getCastleTexturePath(ownerId));
@@ -35,87 +35,57 @@ Castle::Castle(int x, int y, int width, int height, int ownerId, std::vector<std
 
 void Castle::update()
 {
-  uint32_t currentTime = SDL_GetTicks();
-  if (currentTime - lastSpawnTime >= (spawnInterval * spawnRateMultiplier))
+  uint32_t currentTick = Game::tick;
+  if (Game::ticksToMilliseconds(currentTick - lastSpawnTick) >= (spawnInterval * spawnRateMultiplier))
   { // 10000 ms = 10 s
 
     if (isAlive())
     {
       spawnUnit();
     }
-    lastSpawnTime = currentTime;
+    lastSpawnTick = currentTick;
   }
 }
 
-void Castle::render()
+void Castle::capture(RenderSnapshot::Sprite &target) const
 {
-  if (texture != nullptr)
-  {
-    SDL_RenderCopy(Game::renderer, texture, NULL, &objectRect);
-  }
-
-  // Create a rectangle for the total health (red)
-  SDL_Rect healthBarRect;
-  healthBarRect.x = objectRect.x;
-  healthBarRect.y = objectRect.y - 6; // Position it 6px above the unit
-  healthBarRect.w = 48;
-  healthBarRect.h = 4;
-
-  // Render the total health bar (red)
-  SDL_SetRenderDrawColor(Game::renderer, 255, 0, 0, 255);
-  SDL_RenderFillRect(Game::renderer, &healthBarRect);
-
-  // Create a rectangle for the current health (green)
-  SDL_Rect currentHealthRect;
-  currentHealthRect.x = objectRect.x;
-  currentHealthRect.y = objectRect.y - 6;                      // Position it 6px above the unit
-  currentHealthRect.w = (int)((float)health / maxHealth * 48); // Scale it according to the current health percentage
-  currentHealthRect.h = 4;
-
-  // Render the current health bar (green)
-  if (isAlive())
-  {
-    SDL_SetRenderDrawColor(Game::renderer, 0, 255, 0, 255);
-    SDL_RenderFillRect(Game::renderer, &currentHealthRect);
-  }
+  target.previous = {objectRect.x, objectRect.y};
+  target.rect = objectRect;
+  target.region = sprite;
+  target.texture = texture;
+  target.health = health;
+  target.maxHealth = maxHealth;
+  target.healthBarWidth = 48;
 }
 
-void Castle::spawnUnit(int x, int y, const std::string &type, int health)
+std::unique_ptr<Unit> Castle::createUnit(int x, int y, UnitType type)
 {
+  const UnitStats &stats = getUnitStats(type);
+  int health = stats.health * healthMultiplier;
+  float speed = stats.speed / Game::ticksPerSecond * speedMultiplier;
 
-  if (type == "soldier")
-  {
-    auto soldier = std::make_unique<Soldier>(x, y, 16, 16, "soldier", 60 * healthMultiplier, 0.14 * speedMultiplier, baseAttackDamage, baseAttackSpeed * hasteMultiplier, ownerId, 2.0, allUnits, unitsToRemove, allWalls, allResources, allCastles);
-    soldier->setTexture(getSoldierTexturePath(ownerId).first);
-    soldier->setHealth(health);
-    allUnits.push_back(std::move(soldier));
-  }
-  if (type == "worker")
-  {
-    auto worker = std::make_unique<Worker>(x, y, 16, 16, "worker", 40 * healthMultiplier, 0.22 * speedMultiplier, gatherRate * hasteMultiplier, wood, crystals, ownerId, 1.0, allUnits, unitsToRemove, allWalls, allResources, allCastles);
-    worker->setTexture(getWorkerTexturePath(ownerId).first);
-    worker->setHealth(health);
-    allUnits.push_back(std::move(worker));
-  }
+  std::unique_ptr<Unit> unit;
+  if (type == SOLDIER)
+    unit = std::make_unique<Soldier>(x, y, stats.width, stats.height, type, health, speed, baseAttackDamage, baseAttackSpeed * hasteMultiplier, ownerId, stats.radius, allUnits, unitsToRemove, allWalls, allResources, allCastles);
+  else
+    unit = std::make_unique<Worker>(x, y, stats.width, stats.height, type, health, speed, gatherRate * hasteMultiplier, wood, crystals, ownerId, stats.radius, allUnits, unitsToRemove, allWalls, allResources, allCastles);
+
+  unit->setTexture(getUnitTexturePath(type, ownerId).first);
+  return unit;
 }
 
-void Castle::spawnUnit(const std::string &type)
+void Castle::spawnUnit(int x, int y, UnitType type, int health)
 {
+  auto unit = createUnit(x, y, type);
+  unit->setHealth(health);
+  allUnits.push_back(std::move(unit));
+}
 
-  if (type == "soldier")
-  {
-    auto soldier = std::make_unique<Soldier>((objectRect.x + (objectRect.w / 2)) - 8, objectRect.y + objectRect.h - 16, 16, 16, "soldier", 60 * healthMultiplier, 0.14 * speedMultiplier, baseAttackDamage, baseAttackSpeed * hasteMultiplier, ownerId, 2.0, allUnits, unitsToRemove, allWalls, allResources, allCastles);
-    soldier->setTexture(getSoldierTexturePath(ownerId).first);
-    soldier->moveTo((objectRect.x + (objectRect.w / 2)) - 8, objectRect.y + objectRect.h);
-    allUnits.push_back(std::move(soldier));
-  }
-  if (type == "worker")
-  {
-    auto worker = std::make_unique<Worker>((objectRect.x + (objectRect.w / 2)) - 8, objectRect.y + objectRect.h - 16, 16, 16, "worker", 40 * healthMultiplier, 0.22 * speedMultiplier, gatherRate * hasteMultiplier, wood, crystals, ownerId, 1.0, allUnits, unitsToRemove, allWalls, allResources, allCastles);
-    worker->setTexture(getWorkerTexturePath(ownerId).first);
-    worker->moveTo((objectRect.x + (objectRect.w / 2)) - 8, objectRect.y + objectRect.h);
-    allUnits.push_back(std::move(worker));
-  }
+void Castle::spawnUnit(UnitType type)
+{
+  auto unit = createUnit((objectRect.x + (objectRect.w / 2)) - 8, objectRect.y + objectRect.h - 16, type);
+  unit->moveTo((objectRect.x + (objectRect.w / 2)) - 8, objectRect.y + objectRect.h);
+  allUnits.push_back(std::move(unit));
 }
 
 void Castle::spawnUnit()
@@ -123,11 +93,11 @@ void Castle::spawnUnit()
   int randNum = randomInt(0, 100);
   if (randNum < 70)
   {
-    spawnUnit("soldier");
+    spawnUnit(SOLDIER);
   }
   else
   {
-    spawnUnit("worker");
+    spawnUnit(WORKER);
   }
 }
 
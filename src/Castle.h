@@ -7,6 +7,8 @@
 #include "Resource.h"
 #include "Castle.h"
 #include "Unit.h"
+#include "UnitStore.h"
+#include "RenderSnapshot.h"
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,7 +51,7 @@ public:
    * @param crystals Amount of crystals.
    * @param spawnInterval Spawn interval.
    */
-  Castle(int x, int y, int width, int height, int ownerId, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles, float &speedMultiplier, float &healthMultiplier, float &spawnRateMultiplier, float &hasteMultiplier, int &baseAttackDamage, uint32_t &baseAttackSpeed, uint32_t &gatherRate, int &wood, int &crystals, uint32_t &spawnInterval);
+  Castle(int x, int y, int width, int height, int ownerId, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles, float &speedMultiplier, float &healthMultiplier, float &spawnRateMultiplier, float &hasteMultiplier, int &baseAttackDamage, uint32_t &baseAttackSpeed, uint32_t &gatherRate, int &wood, int &crystals, uint32_t &spawnInterval);
 
   /**
    * @brief Default destructor of the Castle object
@@ -64,25 +66,27 @@ public:
   void update() override;
 
   /**
-   * @brief Renders the Castle and its health bar on the screen.
+   * @brief Copies what is needed to draw the Castle and its health bar into a render snapshot.
+   *
+   * @param target The sprite of the snapshot to fill.
    */
-  void render() override;
+  void capture(RenderSnapshot::Sprite &target) const;
 
   /**
    * @brief Spawns a unit of a specific type near the Castle.
-   * @param type The type of the unit ("soldier" or "worker").
+   * @param type The type of the unit.
    */
-  void spawnUnit(const std::string &type);
+  void spawnUnit(UnitType type);
 
   /**
    * @brief Spawns a unit of a specific type at a specified location with a specified health.
    * Method used by Save object to load in saved Units
    * @param x The x coordinate of the new unit's position.
    * @param y The y coordinate of the new unit's position.
-   * @param type The type of the unit ("soldier" or "worker").
+   * @param type The type of the unit.
    * @param health The health of the new unit.
    */
-  void spawnUnit(int x, int y, const std::string &type, int health);
+  void spawnUnit(int x, int y, UnitType type, int health);
 
   /**
    * @brief Spawns a random unit type near the Castle.
@@ -140,12 +144,21 @@ public:
   void die();
 
 private:
+  /**
+   * @brief Creates a unit of the Castle's owner from the base stats of its type and the owner's talents.
+   * @param x The x coordinate of the new unit's position.
+   * @param y The y coordinate of the new unit's position.
+   * @param type The type of the unit.
+   * @return The new unit, not yet added to the level.
+   */
+  std::unique_ptr<Unit> createUnit(int x, int y, UnitType type);
+
   int maxHealth;
   int health;
   int ownerId;
 
   std::vector<std::unique_ptr<Unit>> &allUnits;
-  std::vector<Unit *> &unitsToRemove;
+  std::vector<UnitHandle> &unitsToRemove;
   std::vector<std::unique_ptr<Wall>> &allWalls;
   std::vector<std::unique_ptr<Resource>> &allResources;
   std::vector<Castle *> &allCastles;
@@ -162,7 +175,7 @@ private:
   int &crystals;
 
   uint32_t &spawnInterval;
-  uint32_t lastSpawnTime;
+  uint32_t lastSpawnTick;
 
   std::pair<int, int> damageFrom;
 };
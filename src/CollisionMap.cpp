@@ -0,0 +1,80 @@
+#include "CollisionMap.h"
+#include <algorithm>
+
+namespace
+{
+  // Division rounding towards negative infinity, pixels left of or above the raster map to negative tiles
+  int floorDiv(int value, int divisor)
+  {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+  }
+}
+
+CollisionMap::CollisionMap() : originX(0), originY(0), tileSize(16) {}
+
+void CollisionMap::reset(int x, int y, int columns, int rows, int tileSize)
+{
+  originX = x;
+  originY = y;
+  this->tileSize = tileSize;
+
+  freeTiles.reset(columns, rows);
+  for (int row = 0; row < rows; ++row)
+  {
+    for (int column = 0; column < columns; ++column)
+    {
+      freeTiles.set(column, row, true);
+    }
+  }
+}
+
+bool CollisionMap::tileRange(const SDL_Rect &rect, int &left, int &top, int &right, int &bottom) const
+{
+  if (rect.w <= 0 || rect.h <= 0)
+    return false;
+
+  left = std::max(floorDiv(rect.x - originX, tileSize), 0);
+  top = std::max(floorDiv(rect.y - originY, tileSize), 0);
+  right = std::min(floorDiv(rect.x + rect.w - 1 - originX, tileSize), freeTiles.getWidth() - 1);
+  bottom = std::min(floorDiv(rect.y + rect.h - 1 - originY, tileSize), freeTiles.getHeight() - 1);
+  return left <= right && top <= bottom;
+}
+
+void CollisionMap::fill(const SDL_Rect &rect, bool free)
+{
+  int left, top, right, bottom;
+  if (!tileRange(rect, left, top, right, bottom))
+    return;
+
+  for (int y = top; y <= bottom; ++y)
+  {
+    for (int x = left; x <= right; ++x)
+    {
+      freeTiles.set(x, y, free);
+    }
+  }
+}
+
+void CollisionMap::block(const SDL_Rect &rect) { fill(rect, false); }
+
+void CollisionMap::clear(const SDL_Rect &rect) { fill(rect, true); }
+
+bool CollisionMap::collides(const SDL_Rect &rect) const
+{
+  int left, top, right, bottom;
+  if (!tileRange(rect, left, top, right, bottom))
+    return false;
+
+  // A unit spans one or two tiles per row, every row is checked with one span read
+  for (int y = top; y <= bottom; ++y)
+  {
+    for (int x = left; x <= right; x += 64)
+    {
+      int count = std::min(right - x + 1, 64);
+      uint64_t mask = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+      if ((freeTiles.row(x, y) & mask) != mask)
+        return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,74 @@
+#ifndef COLLISIONMAP_H
+#define COLLISIONMAP_H
+
+#include "BitGrid.h"
+#include <SDL2/SDL.h>
+
+/**
+ * @class CollisionMap
+ * @brief Occupancy raster of the static objects of a level.
+ *
+ * Walls, castles and resources never move and are aligned to the tile grid, so they are rasterized once into a bit
+ * per tile. Testing a rectangle against all static objects then only reads the rows of tiles it overlaps instead of
+ * intersecting it with every object. Tiles outside the raster are free, like the empty space around the objects.
+ */
+class CollisionMap
+{
+public:
+  /**
+   * @brief Constructs an empty collision map.
+   */
+  CollisionMap();
+
+  /**
+   * @brief Sets the area covered by the raster and marks every tile as free.
+   *
+   * @param x The x-coordinate of the top-left corner of the area in pixels.
+   * @param y The y-coordinate of the top-left corner of the area in pixels.
+   * @param columns The width of the area in tiles.
+   * @param rows The height of the area in tiles.
+   * @param tileSize The width and height of a tile in pixels.
+   */
+  void reset(int x, int y, int columns, int rows, int tileSize = 16);
+
+  /**
+   * @brief Marks the tiles overlapped by an object as occupied.
+   *
+   * @param rect The rectangle of the object in pixels.
+   */
+  void block(const SDL_Rect &rect);
+
+  /**
+   * @brief Marks the tiles overlapped by an object as free again, for objects removed from the level.
+   *
+   * @param rect The rectangle of the object in pixels.
+   */
+  void clear(const SDL_Rect &rect);
+
+  /**
+   * @brief Checks whether a rectangle overlaps any occupied tile.
+   *
+   * @param rect The rectangle to test in pixels.
+   * @return bool True if the rectangle intersects a static object, false otherwise.
+   */
+  bool collides(const SDL_Rect &rect) const;
+
+private:
+  /**
+   * @brief Returns the range of tiles overlapped by a rectangle, clamped to the raster.
+   *
+   * @return bool False if the rectangle lies completely outside the raster.
+   */
+  bool tileRange(const SDL_Rect &rect, int &left, int &top, int &right, int &bottom) const;
+
+  /**
+   * @brief Marks the tiles overlapped by a rectangle as free or occupied.
+   */
+  void fill(const SDL_Rect &rect, bool free);
+
+  int originX, originY;
+  int tileSize;
+  BitGrid freeTiles;
+};
+
+#endif
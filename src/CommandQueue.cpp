@@ -0,0 +1,14 @@
+#include "CommandQueue.h"
+
+void CommandQueue::push(const PlayerCommand &command)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  pending.push_back(command);
+}
+
+void CommandQueue::drain(std::vector<PlayerCommand> &commands)
+{
+  commands.clear();
+  std::lock_guard<std::mutex> lock(mutex);
+  pending.swap(commands);
+}
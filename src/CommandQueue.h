@@ -0,0 +1,58 @@
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <mutex>
+#include <vector>
+
+/**
+ * @struct PlayerCommand
+ * @brief An order of the player, given on the input thread and carried out by the simulation.
+ */
+struct PlayerCommand
+{
+  /**
+   * @enum Type
+   * @brief The kind of order.
+   */
+  enum Type
+  {
+    CLICK_AREA,  /**< Selects the units in the area, or sends the selected units to its end if there are any. */
+    DESELECT_ALL /**< Drops the selection without giving an order. */
+  };
+
+  Type type;
+  int startX, startY; /**< Where the mouse was pressed. */
+  int endX, endY;     /**< Where the mouse was released. */
+};
+
+/**
+ * @class CommandQueue
+ * @brief Passes player commands from the input thread to the simulation thread.
+ *
+ * Commands are carried out at the start of the next tick in the order they were given, so a tick never sees half of
+ * an order. Both sides only hold the lock to append or to swap the list.
+ */
+class CommandQueue
+{
+public:
+  /**
+   * @brief Appends a command, called by the input thread.
+   *
+   * @param command The command to carry out.
+   */
+  void push(const PlayerCommand &command);
+
+  /**
+   * @brief Takes all commands given since the last call, called by the simulation thread.
+   *
+   * @param commands Cleared and filled with the commands in the order they were given, its memory is reused by the
+   * queue on the next call.
+   */
+  void drain(std::vector<PlayerCommand> &commands);
+
+private:
+  std::mutex mutex;
+  std::vector<PlayerCommand> pending;
+};
+
+#endif
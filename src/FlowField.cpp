@@ -0,0 +1,166 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <functional>
+
+namespace
+{
+  // Step directions stored by index in the direction field, the reverse of direction i is i ^ 1
+  const int stepX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+  const int stepY[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+}
+
+FlowField::FlowField(const Map &map, int goalX, int goalY, int goalWidth, int goalHeight)
+    : width(map.getWidth()),
+      height(map.getHeight()),
+      goalX(goalX),
+      goalY(goalY),
+      goalWidth(goalWidth),
+      goalHeight(goalHeight)
+{
+  compute(map);
+}
+
+FlowField::~FlowField() = default;
+
+void FlowField::compute(const Map &map)
+{
+  const float infinity = std::numeric_limits<float>::infinity();
+  integration.assign(static_cast<size_t>(width) * height, infinity);
+  direction.assign(static_cast<size_t>(width) * height, -1);
+
+  // Min-heap of (cost, index)
+  std::vector<std::pair<float, int>> open;
+  auto push = [&open](float cost, int index)
+  {
+    open.push_back({cost, index});
+    std::push_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+  };
+
+  auto seed = [&](int x, int y)
+  {
+    if (map.isAccessible(x, y) && integration[y * width + x] != 0)
+    {
+      integration[y * width + x] = 0;
+      push(0, y * width + x);
+    }
+  };
+
+  for (int y = goalY; y < goalY + goalHeight; ++y)
+  {
+    for (int x = goalX; x < goalX + goalWidth; ++x)
+    {
+      seed(x, y);
+    }
+  }
+
+  // The goal itself is solid, gather on the tiles along its sides instead
+  if (open.empty())
+  {
+    for (int y = goalY; y < goalY + goalHeight; ++y)
+    {
+      seed(goalX - 1, y);
+      seed(goalX + goalWidth, y);
+    }
+    for (int x = goalX; x < goalX + goalWidth; ++x)
+    {
+      seed(x, goalY - 1);
+      seed(x, goalY + goalHeight);
+    }
+  }
+
+  while (!open.empty())
+  {
+    std::pop_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+    std::pair<float, int> current = open.back();
+    open.pop_back();
+
+    if (current.first > integration[current.second])
+      continue;
+
+    int x = current.second % width;
+    int y = current.second / width;
+
+    for (int i = 0; i < 8; ++i)
+    {
+      int nextX = x + stepX[i];
+      int nextY = y + stepY[i];
+
+      if (!map.isAccessible(nextX, nextY))
+        continue;
+
+      // Diagonal movement check, same corner rule as A*
+      if (stepX[i] != 0 && stepY[i] != 0 && (!map.isAccessible(x + stepX[i], y) || !map.isAccessible(x, y + stepY[i])))
+        continue;
+
+      float cost = current.first + ((stepX[i] != 0 && stepY[i] != 0) ? static_cast<float>(M_SQRT2) : 1.0f);
+      int nextIndex = nextY * width + nextX;
+      if (cost < integration[nextIndex])
+      {
+        integration[nextIndex] = cost;
+        // The neighbour steps back towards the tile it was reached from
+        direction[nextIndex] = static_cast<int8_t>(i ^ 1);
+        push(cost, nextIndex);
+      }
+    }
+  }
+}
+
+bool FlowField::hasGoal(int goalX, int goalY, int goalWidth, int goalHeight) const
+{
+  return this->goalX == goalX && this->goalY == goalY && this->goalWidth == goalWidth && this->goalHeight == goalHeight;
+}
+
+bool FlowField::isReachable(int x, int y) const
+{
+  if (x < 0 || x >= width || y < 0 || y >= height)
+  {
+    return false;
+  }
+  return integration[y * width + x] != std::numeric_limits<float>::infinity();
+}
+
+bool FlowField::isGoal(int x, int y) const
+{
+  return isReachable(x, y) && integration[y * width + x] == 0;
+}
+
+float FlowField::getCost(int x, int y) const
+{
+  if (!isReachable(x, y))
+  {
+    return std::numeric_limits<float>::infinity();
+  }
+  return integration[y * width + x];
+}
+
+std::pair<int, int> FlowField::getDirection(int x, int y) const
+{
+  if (!isReachable(x, y) || direction[y * width + x] < 0)
+  {
+    return {0, 0};
+  }
+  int index = direction[y * width + x];
+  return {stepX[index], stepY[index]};
+}
+
+void FlowField::tracePath(int startX, int startY, WaypointBuffer &path) const
+{
+  path.clear();
+  if (!isReachable(startX, startY))
+  {
+    return;
+  }
+
+  int x = startX;
+  int y = startY;
+  path.pushCorner({x, y});
+  while (!isGoal(x, y))
+  {
+    std::pair<int, int> step = getDirection(x, y);
+    x += step.first;
+    y += step.second;
+    path.pushCorner({x, y});
+  }
+}
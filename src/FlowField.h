@@ -0,0 +1,114 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "Map.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/**
+ * @class FlowField
+ * @brief Shared navigation field towards one destination on the map.
+ *
+ * A flow field is computed once per destination with a Dijkstra search spreading out from the goal. It stores the
+ * integrated cost to reach the goal from every tile (integration field) and the direction of the next step from
+ * every tile (direction field). Any number of units heading to the same destination can then follow it without
+ * running their own search. Movement follows the same rules as A*, 8 directions without cutting blocked corners.
+ *
+ * The goal is a rectangle of tiles. If none of its tiles are accessible (castles, resources), the accessible tiles
+ * along its sides become the goal instead, so units gather around the object.
+ */
+class FlowField
+{
+public:
+  /**
+   * @brief Constructs and computes a flow field towards a goal rectangle.
+   *
+   * @param map The map to compute the field on.
+   * @param goalX The x-coordinate of the top-left tile of the goal.
+   * @param goalY The y-coordinate of the top-left tile of the goal.
+   * @param goalWidth The width of the goal in tiles.
+   * @param goalHeight The height of the goal in tiles.
+   */
+  FlowField(const Map &map, int goalX, int goalY, int goalWidth = 1, int goalHeight = 1);
+
+  /**
+   * @brief Default destructor for the FlowField class.
+   */
+  ~FlowField();
+
+  /**
+   * @brief Checks whether the field was computed for the given goal rectangle.
+   *
+   * @param goalX The x-coordinate of the top-left tile of the goal.
+   * @param goalY The y-coordinate of the top-left tile of the goal.
+   * @param goalWidth The width of the goal in tiles.
+   * @param goalHeight The height of the goal in tiles.
+   * @return bool True if the field leads to this goal, false otherwise.
+   */
+  bool hasGoal(int goalX, int goalY, int goalWidth, int goalHeight) const;
+
+  /**
+   * @brief Checks whether the goal can be reached from a tile.
+   *
+   * @param x The x-coordinate of the tile.
+   * @param y The y-coordinate of the tile.
+   * @return bool True if the goal is reachable from the tile, false otherwise.
+   */
+  bool isReachable(int x, int y) const;
+
+  /**
+   * @brief Checks whether a tile is part of the goal.
+   *
+   * @param x The x-coordinate of the tile.
+   * @param y The y-coordinate of the tile.
+   * @return bool True if the tile is a goal tile, false otherwise.
+   */
+  bool isGoal(int x, int y) const;
+
+  /**
+   * @brief Returns the integrated cost of reaching the goal from a tile.
+   *
+   * @param x The x-coordinate of the tile.
+   * @param y The y-coordinate of the tile.
+   * @return float The cost to the goal, or infinity if the goal is unreachable from the tile.
+   */
+  float getCost(int x, int y) const;
+
+  /**
+   * @brief Returns the direction of the next step towards the goal from a tile.
+   *
+   * @param x The x-coordinate of the tile.
+   * @param y The y-coordinate of the tile.
+   * @return std::pair<int, int> The step (dx, dy), or (0, 0) for goal tiles and tiles the goal can't be reached from.
+   */
+  std::pair<int, int> getDirection(int x, int y) const;
+
+  /**
+   * @brief Follows the direction field from a tile to the goal.
+   *
+   * The path has the same format as from Map::calculatePath, it starts with the start tile and ends on a goal tile.
+   *
+   * @param startX The x-coordinate of the start tile.
+   * @param startY The y-coordinate of the start tile.
+   * @param path Output buffer for the corners of the path, empty if the goal is unreachable.
+   */
+  void tracePath(int startX, int startY, WaypointBuffer &path) const;
+
+private:
+  /**
+   * @brief Runs the Dijkstra search from the goal tiles and fills the integration and direction fields.
+   *
+   * @param map The map to compute the field on.
+   */
+  void compute(const Map &map);
+
+  int width;
+  int height;
+  int goalX, goalY, goalWidth, goalHeight;
+
+  std::vector<float> integration;
+  std::vector<int8_t> direction;
+};
+
+#endif
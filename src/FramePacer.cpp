@@ -0,0 +1,42 @@
+#include "FramePacer.h"
+
+FramePacer::FramePacer() : frequency(SDL_GetPerformanceFrequency()), period(0), deadline(0)
+{
+  setFrameRate(60);
+}
+
+void FramePacer::setFrameRate(int framesPerSecond)
+{
+  if (framesPerSecond < 1)
+    framesPerSecond = 1;
+
+  period = frequency / framesPerSecond;
+  reset();
+}
+
+void FramePacer::reset()
+{
+  deadline = SDL_GetPerformanceCounter() + period;
+}
+
+void FramePacer::wait()
+{
+  Uint64 now = SDL_GetPerformanceCounter();
+  if (now >= deadline + period)
+  {
+    deadline = now + period;
+    return;
+  }
+
+  Uint64 spin = frequency * spinMilliseconds / 1000;
+  if (deadline > now + spin)
+  {
+    SDL_Delay(static_cast<Uint32>((deadline - now - spin) * 1000 / frequency));
+  }
+
+  while (SDL_GetPerformanceCounter() < deadline)
+  {
+  }
+
+  deadline += period;
+}
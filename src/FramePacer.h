@@ -0,0 +1,51 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SDL2/SDL.h>
+
+/**
+ * @class FramePacer
+ * @brief Holds the game loop to a fixed frame rate without relying on the display.
+ *
+ * Frames are timed against deadlines one frame period apart, so short and long frames even out instead of drifting.
+ * The wait for a deadline sleeps while it is far away and spins for the last few milliseconds, because SDL_Delay may
+ * oversleep by about one scheduler period.
+ */
+class FramePacer
+{
+public:
+  /**
+   * @brief Constructs a frame pacer for 60 frames per second.
+   */
+  FramePacer();
+
+  /**
+   * @brief Sets the number of frames per second to pace to and starts counting from now.
+   *
+   * @param framesPerSecond The frame rate, values below 1 are treated as 1.
+   */
+  void setFrameRate(int framesPerSecond);
+
+  /**
+   * @brief Waits until the deadline of the current frame and moves the deadline one frame ahead.
+   *
+   * If the frame took longer than a whole period, the deadlines start again from now instead of rushing the next
+   * frames to catch up.
+   */
+  void wait();
+
+  /**
+   * @brief Starts counting frames from now, used after the loop waited for something else.
+   */
+  void reset();
+
+private:
+  // Sleeping is only trusted this long before a deadline, the rest is spun
+  static const Uint64 spinMilliseconds = 2;
+
+  Uint64 frequency;
+  Uint64 period;
+  Uint64 deadline;
+};
+
+#endif
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <SDL2/SDL_image.h>
 #include "utils.h"
+#include "Profiler.h"
+#include "FramePacer.h"
 
 using namespace std;
 
@@ -13,6 +15,12 @@ GameState Game::currentState = MENU;
 SDL_Renderer *Game::renderer = nullptr;
 SDL_Window *Game::window = nullptr;
 bool Game::isRunning = false;
+bool Game::headless = false;
+uint32_t Game::tick = 0;
+float Game::interpolation = 0.0f;
+PresentMode Game::presentMode = VSYNC;
+int Game::frameRateCap = 60;
+bool Game::idleInMenus = true;
 ResourceManager Game::resourceManager;
 Save Game::save = Save("./examples/save.txt");
 std::vector<std::pair<std::string, std::string>> Game::levels = {};
@@ -25,11 +33,19 @@ std::unique_ptr<LevelScene> Game::currentLevelScene = nullptr;
 void Game::changeState(GameState newState, const std::pair<std::string, std::string> &levelData)
 {
   resetCursor();
+
+  // A level that is left stops simulating, it is only kept until the next one replaces it
+  if (currentState == GameState::LEVEL && newState != GameState::LEVEL && currentLevelScene)
+  {
+    currentLevelScene->stopSimulation();
+  }
+
   currentState = newState;
 
   if (newState == GameState::LEVEL)
   {
     currentLevelScene = std::make_unique<LevelScene>(levelData);
+    currentLevelScene->startSimulation();
   }
 }
 
@@ -54,7 +70,9 @@ bool Game::init(const char *title, int xpos, int ypos, int width, int height, bo
     window = SDL_CreateWindow(title, xpos, ypos, width, height, flags);
     if (window)
     {
-      renderer = SDL_CreateRenderer(window, -1, 0);
+      renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+      if (!renderer)
+        renderer = SDL_CreateRenderer(window, -1, 0); // No GPU, the software renderer still works
       if (renderer)
       {
         SDL_SetRenderDrawColor(renderer, 5, 25, 35, 255);
@@ -83,20 +101,71 @@ bool Game::init(const char *title, int xpos, int ypos, int width, int height, bo
   }
 
   loadGameConfig("./examples/config.txt");
+  applyPresentMode();
 
   save.init();
 
+  resourceManager.buildAtlas(getLevelSpritePaths());
+
   mainMenuScene = make_unique<MenuScene>();
   levelSelectScene = make_unique<LevelSelectScene>();
 
   return true;
 }
 
+void Game::applyPresentMode()
+{
+  if (SDL_RenderSetVSync(renderer, presentMode == VSYNC ? 1 : 0) != 0 && presentMode == VSYNC)
+  {
+    printf("VSync is not supported by the renderer, limiting the frame rate to %d instead.\n", frameRateCap);
+    presentMode = LIMITED;
+  }
+}
+
+bool Game::initHeadless()
+{
+  headless = true;
+  isRunning = true;
+
+  loadGameConfig("./examples/config.txt");
+
+  return true;
+}
+
+std::unique_ptr<LevelScene> Game::runHeadless(const std::string &levelPath, uint32_t maxTicks)
+{
+  tick = 0;
+  interpolation = 0.0f;
+  currentState = LEVEL;
+
+  std::unique_ptr<LevelScene> level = std::make_unique<LevelScene>(std::make_pair(std::string("headless"), levelPath));
+  if (!level->isLoaded())
+  {
+    return nullptr;
+  }
+
+  while (isRunning && !level->isGameOver() && tick < maxTicks)
+  {
+    level->update();
+    tick++;
+  }
+  return level;
+}
+
 void Game::handleEvents()
 {
+  PROFILE_SCOPE("Game::handleEvents");
   SDL_Event event;
   while (SDL_PollEvent(&event))
   {
+#ifdef ENABLE_PROFILING
+    // F9 saves the zones recorded so far, named after the tick it was pressed at
+    if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F9)
+    {
+      Profiler::writeTrace("./trace_" + std::to_string(tick) + ".json");
+    }
+#endif
+
     switch (currentState)
     {
     case MENU:
@@ -114,6 +183,7 @@ void Game::handleEvents()
 
 void Game::update()
 {
+  PROFILE_SCOPE("Game::update");
   switch (currentState)
   {
   case MENU:
@@ -123,7 +193,7 @@ void Game::update()
     levelSelectScene->update();
     break;
   case LEVEL:
-    currentLevelScene->update();
+    currentLevelScene->updateInterface();
     break;
   default:
     mainMenuScene->update();
@@ -133,6 +203,7 @@ void Game::update()
 
 void Game::render()
 {
+  PROFILE_SCOPE("Game::render");
   SDL_RenderClear(renderer);
   switch (currentState)
   {
@@ -154,6 +225,12 @@ void Game::render()
 
 void Game::cleanup()
 {
+#ifdef ENABLE_PROFILING
+  Profiler::writeTrace("./trace.json");
+#endif
+
+  // Stops the simulation thread, and frees the units while the unit store they are in still exists
+  currentLevelScene.reset();
 
   resourceManager.freeAllResources();
 
@@ -164,11 +241,60 @@ void Game::cleanup()
 
 void Game::run()
 {
+  const double tickDuration = 1.0 / ticksPerSecond;
+  // After a stall (window dragged, debugger) skip the missed time instead of running hundreds of ticks to catch up
+  const double maxFrameDuration = 0.25;
+
+  FramePacer pacer;
+  pacer.setFrameRate(frameRateCap);
+
+  uint64_t previousTime = SDL_GetPerformanceCounter();
+  double accumulator = 0.0;
+
   while (isRunning)
   {
+    // Menus only change on input, so they sleep until an event arrives instead of drawing the same frame again
+    if (idleInMenus && currentState != LEVEL)
+    {
+      SDL_WaitEventTimeout(NULL, idleTimeoutMilliseconds);
+    }
+
+    uint64_t currentTime = SDL_GetPerformanceCounter();
+    accumulator += static_cast<double>(currentTime - previousTime) / SDL_GetPerformanceFrequency();
+    previousTime = currentTime;
+    if (accumulator > maxFrameDuration)
+    {
+      accumulator = maxFrameDuration;
+    }
+
     handleEvents();
-    update();
+    if (currentState == LEVEL)
+    {
+      // The level ticks on its own thread, the loop only keeps its menus up to date and draws its snapshots
+      accumulator = 0.0;
+      update();
+    }
+    else
+    {
+      while (accumulator >= tickDuration && isRunning)
+      {
+        update();
+        tick++;
+        accumulator -= tickDuration;
+      }
+      interpolation = static_cast<float>(accumulator / tickDuration);
+    }
     render();
+
+    if (presentMode == LIMITED)
+    {
+      pacer.wait();
+    }
   }
   cleanup();
+}
+
+uint32_t Game::ticksToMilliseconds(uint32_t ticks)
+{
+  return static_cast<uint32_t>(static_cast<uint64_t>(ticks) * 1000 / ticksPerSecond);
 }
\ No newline at end of file
@@ -26,6 +26,19 @@ enum GameState
   LEVEL         /**< Represents the game state where an actual level is being played. */
 };
 
+/**
+ * @enum PresentMode
+ * @brief Defines how the game loop paces the frames it presents.
+ *
+ * Selected with the mode entry of the Display section of the game config.
+ */
+enum PresentMode
+{
+  VSYNC,   /**< Presenting waits for the vertical blank of the display. */
+  LIMITED, /**< Frames are paced to Game::frameRateCap by sleeping and spinning. */
+  UNCAPPED /**< Frames are presented as fast as possible, for benchmarking. */
+};
+
 /**
  * @class Game
  * @brief Game Management Class
@@ -63,7 +76,36 @@ public:
   bool init(const char *title, int xpos, int ypos, int width, int height, bool fullscreen);
 
   /**
-   * @brief Runs the game loop. Handles events, updates the game state, and renders the game until the game stops running.
+   * @brief Applies the presentation mode of the game config to the renderer.
+   * Falls back to the frame limiter if the renderer cannot wait for the vertical blank.
+   */
+  void applyPresentMode();
+
+  /**
+   * @brief Initializes the game without SDL, a window or a renderer.
+   * Only the game configuration is loaded. Textures and fonts are never loaded and levels are created without menus,
+   * so matches can be simulated on machines without a display.
+   * @return True if initialization was successful, false otherwise.
+   */
+  bool initHeadless();
+
+  /**
+   * @brief Plays a level without rendering until it is over or a number of ticks has passed.
+   * Ticks are run back to back without waiting for real time. The tick counter starts from zero for every level.
+   * @param levelPath Path to the level file.
+   * @param maxTicks The maximum number of ticks to simulate.
+   * @return The level after the last tick, or nullptr if it could not be loaded.
+   */
+  std::unique_ptr<LevelScene> runHeadless(const std::string &levelPath, uint32_t maxTicks);
+
+  /**
+   * @brief Runs the game loop until the game stops running.
+   * Events are handled and the game is rendered once per frame. The game state is updated in fixed ticks of
+   * 1 / ticksPerSecond seconds, as many as the time passed since the last frame covers, so the simulation runs at the
+   * same speed no matter the frame rate. The time left over is stored in interpolation for rendering. A level is not
+   * ticked here, it runs on its own simulation thread, see LevelScene::startSimulation.
+   * Frames are paced according to presentMode. Outside of a level the loop can instead sleep until an event arrives,
+   * see idleInMenus.
    */
   void run();
 
@@ -74,6 +116,7 @@ public:
 
   /**
    * @brief Updates the game state by delegating to the update function of the active scene.
+   * For a level only its interface is updated, the level simulates on its own thread.
    */
   void update();
 
@@ -89,6 +132,7 @@ public:
 
   /**
    * @brief Changes the game state to the new specified state, potentially initiating a new level.
+   * Leaving a level stops its simulation thread, a new level starts one.
    * @param newState The new game state to switch to.
    * @param levelData A pair containing data for the new level (if the new state is LEVEL).
    */
@@ -105,6 +149,21 @@ public:
    */
   static void resetCursor();
 
+  /**
+   * @brief Converts a number of simulation ticks to milliseconds of game time.
+   * @param ticks The number of ticks.
+   * @return The game time in milliseconds.
+   */
+  static uint32_t ticksToMilliseconds(uint32_t ticks);
+
+  static const int ticksPerSecond = 60;            /**< Rate of the fixed simulation clock. */
+  static const int idleTimeoutMilliseconds = 100;  /**< Longest sleep of an idle menu, so it still updates without input. */
+  static PresentMode presentMode;                  /**< How frames are paced, see PresentMode. */
+  static int frameRateCap;                         /**< Frames per second in the LIMITED presentation mode. */
+  static bool idleInMenus;                         /**< True if the menus sleep until an event arrives instead of redrawing. */
+  static uint32_t tick;                            /**< Number of simulation ticks run so far, the clock for all gameplay timers. */
+  static float interpolation;                      /**< Fraction of a tick passed since the last update, used to smooth rendering. */
+
   static GameState currentState;
   static Save save;
 
@@ -121,6 +180,7 @@ public:
   static SDL_Window *window;
   static ResourceManager resourceManager;
   static bool isRunning;
+  static bool headless; /**< True if the game runs without a window, see initHeadless. */
 };
 
 #endif // GAME_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "GameObject.h"
+#include "SpriteBatch.h"
 #include <string>
 
 /**
@@ -20,6 +21,7 @@ GameObject::GameObject(int x, int y, int width, int height)
   objectRect.h = height;
 
   texture = nullptr;
+  sprite = nullptr;
 }
 
 void GameObject::render()
@@ -30,6 +32,18 @@ void GameObject::render()
   }
 }
 
+void GameObject::draw(SpriteBatch &batch)
+{
+  if (sprite)
+  {
+    batch.addSprite(*sprite, objectRect);
+  }
+  else if (texture)
+  {
+    batch.addTexture(texture, objectRect);
+  }
+}
+
 void GameObject::update()
 {
 }
@@ -56,13 +70,25 @@ std::pair<int, int> GameObject::getSize() const
   return {objectRect.w, objectRect.h};
 }
 
+const SDL_Rect &GameObject::getRect() const
+{
+  return objectRect;
+}
+
 // AABB collision detection using SDL_Rect's and SDL's built in function
 bool GameObject::checkCollision(const GameObject &other) const
 {
-  return SDL_HasIntersection(&objectRect, &other.objectRect);
+  return SDL_HasIntersection(&getRect(), &other.getRect());
+}
+
+bool GameObject::checkCollisionAt(int x, int y, const GameObject &other) const
+{
+  SDL_Rect movedRect = {x, y, objectRect.w, objectRect.h};
+  return SDL_HasIntersection(&movedRect, &other.getRect());
 }
 
 void GameObject::setTexture(const std::string &filePath)
 {
-  texture = Game::resourceManager.loadTexture(filePath);
+  sprite = Game::resourceManager.getAtlas().find(filePath);
+  texture = sprite ? nullptr : Game::resourceManager.loadTexture(filePath);
 }
@@ -5,6 +5,8 @@
 #include <utility>
 #include <string>
 
+class SpriteBatch;
+
 /**
  * @class GameObject
  * @brief Game Object Base Class
@@ -45,6 +47,16 @@ public:
    */
   virtual void render();
 
+  /**
+   * @brief Adds the GameObject to a sprite batch.
+   *
+   * Objects whose texture is in the texture atlas become a quad of the batch, others are drawn on their own after
+   * flushing it.
+   *
+   * @param batch The batch of the layer the object is drawn in.
+   */
+  virtual void draw(SpriteBatch &batch);
+
   /**
    * @brief Sets the position of the GameObject.
    *
@@ -53,7 +65,7 @@ public:
    * @param x The new x-coordinate of the object.
    * @param y The new y-coordinate of the object.
    */
-  void setPosition(int x, int y);
+  virtual void setPosition(int x, int y);
 
   /**
    * @brief Retrieves the position of the GameObject.
@@ -62,7 +74,7 @@ public:
    *
    * @return A std::pair where first is the x-coordinate and second is the y-coordinate.
    */
-  std::pair<int, int> getPosition() const;
+  virtual std::pair<int, int> getPosition() const;
 
   /**
    * @brief Sets the size of the GameObject.
@@ -83,6 +95,13 @@ public:
    */
   std::pair<int, int> getSize() const;
 
+  /**
+   * @brief Retrieves the bounding rectangle of the GameObject.
+   *
+   * @return The rectangle of the object in pixels.
+   */
+  virtual const SDL_Rect &getRect() const;
+
   /**
    * @brief Checks if the GameObject collides with another GameObject.
    *
@@ -94,10 +113,25 @@ public:
    */
   bool checkCollision(const GameObject &other) const;
 
+  /**
+   * @brief Checks if the GameObject would collide with another GameObject at a different position.
+   *
+   * Same test as checkCollision with the bounding box of this object moved to the given position,
+   * the object itself is not moved.
+   *
+   * @param x The x-coordinate of the position to test.
+   * @param y The y-coordinate of the position to test.
+   * @param other The other GameObject to check collision with.
+   * @return true if the GameObjects would collide, false otherwise.
+   */
+  bool checkCollisionAt(int x, int y, const GameObject &other) const;
+
   /**
    * @brief Sets the texture of the GameObject.
    *
-   * This function allows you to set the texture of the GameObject using a file path.
+   * This function allows you to set the texture of the GameObject using a file path. A texture that is in the texture
+   * atlas is only looked up there, so units can change their texture on the simulation thread without touching the
+   * renderer.
    *
    * @param filePath The file path to the texture.
    */
@@ -107,6 +141,7 @@ public:
 
 protected:
   SDL_Texture *texture;
+  const SDL_Rect *sprite; /**< The region of the texture in the texture atlas, nullptr if it is not in the atlas. */
 };
 
 #endif
\ No newline at end of file
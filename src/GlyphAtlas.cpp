@@ -0,0 +1,49 @@
+#include "GlyphAtlas.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+GlyphAtlas::GlyphAtlas() : lineHeight(0)
+{
+  for (auto &glyph : glyphs)
+  {
+    glyph = {nullptr, 0};
+  }
+}
+
+bool GlyphAtlas::build(SDL_Renderer *renderer, TTF_Font *font)
+{
+  if (font == nullptr)
+    return false;
+
+  std::vector<std::pair<std::string, SDL_Surface *>> surfaces;
+  for (char character = firstCharacter; character <= lastCharacter; ++character)
+  {
+    surfaces.emplace_back(std::string(1, character), TTF_RenderGlyph_Blended(font, static_cast<Uint16>(character), SDL_Color{255, 255, 255, 255}));
+  }
+
+  bool built = atlas.build(renderer, surfaces);
+
+  for (auto &surface : surfaces)
+  {
+    Glyph &glyph = glyphs[surface.first[0] - firstCharacter];
+    glyph.region = atlas.find(surface.first);
+
+    int minX, maxX, minY, maxY, advance;
+    glyph.advance = TTF_GlyphMetrics(font, static_cast<Uint16>(surface.first[0]), &minX, &maxX, &minY, &maxY, &advance) == 0 ? advance : 0;
+
+    if (surface.second != nullptr)
+      SDL_FreeSurface(surface.second);
+  }
+
+  lineHeight = TTF_FontHeight(font);
+  return built;
+}
+
+const GlyphAtlas::Glyph *GlyphAtlas::getGlyph(char character) const
+{
+  if (character < firstCharacter || character > lastCharacter)
+    return nullptr;
+
+  return &glyphs[character - firstCharacter];
+}
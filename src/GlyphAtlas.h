@@ -0,0 +1,74 @@
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "TextureAtlas.h"
+
+/**
+ * @class GlyphAtlas
+ * @brief The printable characters of one font at one size, rasterized once into a texture atlas.
+ *
+ * The glyphs are rendered in white so a text of any color can be drawn from them by tinting the quads. Each glyph
+ * keeps the full line height of the font, so a text is laid out by placing the glyphs next to each other at their
+ * advance.
+ */
+class GlyphAtlas
+{
+public:
+  /**
+   * @struct Glyph
+   * @brief Where a character is in the atlas and how far it moves the next one.
+   */
+  struct Glyph
+  {
+    const SDL_Rect *region;
+    int advance;
+  };
+
+  /**
+   * @brief Constructs an empty glyph atlas, no character is found in it until it is built.
+   */
+  GlyphAtlas();
+
+  /**
+   * @brief Rasterizes the printable ASCII characters of a font into the atlas.
+   *
+   * @param renderer The renderer the texture is created for.
+   * @param font The font to rasterize, it is only used while building.
+   * @return bool True if the atlas texture was created, false otherwise.
+   */
+  bool build(SDL_Renderer *renderer, TTF_Font *font);
+
+  /**
+   * @brief Finds the glyph of a character.
+   *
+   * @param character The character to look up.
+   * @return const Glyph* The glyph, nullptr if the character is not printable ASCII.
+   */
+  const Glyph *getGlyph(char character) const;
+
+  /**
+   * @brief Returns the atlas the glyphs are packed in.
+   *
+   * @return const TextureAtlas& The atlas.
+   */
+  const TextureAtlas &getAtlas() const { return atlas; }
+
+  /**
+   * @brief Returns the height of a line of text.
+   *
+   * @return int The height in pixels, 0 if the atlas was not built.
+   */
+  int getLineHeight() const { return lineHeight; }
+
+private:
+  static const char firstCharacter = ' ';
+  static const char lastCharacter = '~';
+
+  TextureAtlas atlas;
+  Glyph glyphs[lastCharacter - firstCharacter + 1];
+  int lineHeight;
+};
+
+#endif
@@ -0,0 +1,326 @@
+#include "HierarchicalMap.h"
+#include "Map.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+namespace
+{
+  // Runs of open border tiles at least this long get an entrance at each end instead of one in the middle
+  const int longEntranceLength = 6;
+
+  // Octile distance, admissible for 8 directional movement with diagonal cost sqrt(2)
+  float octileDistance(int fromX, int fromY, int toX, int toY)
+  {
+    int dx = std::abs(toX - fromX);
+    int dy = std::abs(toY - fromY);
+    return static_cast<float>(dx + dy) + static_cast<float>(M_SQRT2 - 2.0) * std::min(dx, dy);
+  }
+}
+
+HierarchicalMap::HierarchicalMap(const Map &map, int clusterSize)
+    : width(map.getWidth()),
+      height(map.getHeight()),
+      clusterSize(clusterSize)
+{
+  clustersX = (width + clusterSize - 1) / clusterSize;
+  clustersY = (height + clusterSize - 1) / clusterSize;
+  clusterNodes.assign(static_cast<size_t>(clustersX) * clustersY, {});
+
+  // Entrances, scan every border between two neighbouring clusters for runs of tiles open on both sides
+  for (int clusterY = 0; clusterY < clustersY; ++clusterY)
+  {
+    for (int clusterX = 0; clusterX < clustersX; ++clusterX)
+    {
+      int left = clusterX * clusterSize;
+      int top = clusterY * clusterSize;
+      int right = std::min(left + clusterSize, width);
+      int bottom = std::min(top + clusterSize, height);
+
+      if (right < width)
+      {
+        int runStart = -1;
+        for (int y = top; y <= bottom; ++y)
+        {
+          bool open = y < bottom && map.isAccessible(right - 1, y) && map.isAccessible(right, y);
+          if (open && runStart == -1)
+          {
+            runStart = y;
+          }
+          else if (!open && runStart != -1)
+          {
+            addEntrance(right - 1, runStart, y - runStart, true);
+            runStart = -1;
+          }
+        }
+      }
+
+      if (bottom < height)
+      {
+        int runStart = -1;
+        for (int x = left; x <= right; ++x)
+        {
+          bool open = x < right && map.isAccessible(x, bottom - 1) && map.isAccessible(x, bottom);
+          if (open && runStart == -1)
+          {
+            runStart = x;
+          }
+          else if (!open && runStart != -1)
+          {
+            addEntrance(runStart, bottom - 1, x - runStart, false);
+            runStart = -1;
+          }
+        }
+      }
+    }
+  }
+
+  // Intra-cluster edges, one search per node gives its costs to all other nodes of the cluster
+  std::vector<float> cost;
+  for (const auto &members : clusterNodes)
+  {
+    for (int from : members)
+    {
+      searchCluster(map, nodes[from].x, nodes[from].y, cost);
+      for (int to : members)
+      {
+        float edgeCost = cost[localIndex(nodes[to].x, nodes[to].y)];
+        if (to != from && edgeCost != std::numeric_limits<float>::infinity())
+        {
+          nodes[from].edges.push_back({to, edgeCost});
+        }
+      }
+    }
+  }
+
+  nodeByTile.clear();
+}
+
+HierarchicalMap::~HierarchicalMap() = default;
+
+int HierarchicalMap::clusterAt(int x, int y) const
+{
+  return (y / clusterSize) * clustersX + x / clusterSize;
+}
+
+int HierarchicalMap::localIndex(int x, int y) const
+{
+  return (y % clusterSize) * clusterSize + x % clusterSize;
+}
+
+int HierarchicalMap::nodeAt(int x, int y)
+{
+  auto found = nodeByTile.find(y * width + x);
+  if (found != nodeByTile.end())
+  {
+    return found->second;
+  }
+
+  int index = nodes.size();
+  nodes.push_back({x, y, clusterAt(x, y), {}});
+  clusterNodes[nodes.back().cluster].push_back(index);
+  nodeByTile[y * width + x] = index;
+  return index;
+}
+
+void HierarchicalMap::addEntrance(int x, int y, int length, bool vertical)
+{
+  // The far side of the border is one tile to the right of a vertical border or below a horizontal one
+  int stepX = vertical ? 0 : 1;
+  int stepY = vertical ? 1 : 0;
+  int farX = vertical ? 1 : 0;
+  int farY = vertical ? 0 : 1;
+
+  auto connect = [&](int offset)
+  {
+    int nearNode = nodeAt(x + stepX * offset, y + stepY * offset);
+    int farNode = nodeAt(x + stepX * offset + farX, y + stepY * offset + farY);
+    nodes[nearNode].edges.push_back({farNode, 1.0f});
+    nodes[farNode].edges.push_back({nearNode, 1.0f});
+  };
+
+  if (length < longEntranceLength)
+  {
+    connect(length / 2);
+  }
+  else
+  {
+    connect(0);
+    connect(length - 1);
+  }
+}
+
+void HierarchicalMap::searchCluster(const Map &map, int startX, int startY, std::vector<float> &cost) const
+{
+  const float infinity = std::numeric_limits<float>::infinity();
+  cost.assign(static_cast<size_t>(clusterSize) * clusterSize, infinity);
+
+  int left = (startX / clusterSize) * clusterSize;
+  int top = (startY / clusterSize) * clusterSize;
+  int right = std::min(left + clusterSize, width);
+  int bottom = std::min(top + clusterSize, height);
+
+  // Min-heap of (cost, local index)
+  std::vector<std::pair<float, int>> open;
+  cost[localIndex(startX, startY)] = 0;
+  open.push_back({0.0f, localIndex(startX, startY)});
+
+  while (!open.empty())
+  {
+    std::pop_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+    std::pair<float, int> current = open.back();
+    open.pop_back();
+
+    if (current.first > cost[current.second])
+      continue;
+
+    int x = left + current.second % clusterSize;
+    int y = top + current.second / clusterSize;
+
+    for (int dx = -1; dx <= 1; ++dx)
+    {
+      for (int dy = -1; dy <= 1; ++dy)
+      {
+        if (dx == 0 && dy == 0)
+          continue;
+
+        int nextX = x + dx;
+        int nextY = y + dy;
+
+        // Stay inside the cluster
+        if (nextX < left || nextX >= right || nextY < top || nextY >= bottom || !map.isAccessible(nextX, nextY))
+          continue;
+
+        // Diagonal movement check, same corner rule as A*
+        if (dx != 0 && dy != 0 && (!map.isAccessible(x + dx, y) || !map.isAccessible(x, y + dy)))
+          continue;
+
+        float nextCost = current.first + ((dx != 0 && dy != 0) ? static_cast<float>(M_SQRT2) : 1.0f);
+        int nextIndex = localIndex(nextX, nextY);
+        if (nextCost < cost[nextIndex])
+        {
+          cost[nextIndex] = nextCost;
+          open.push_back({nextCost, nextIndex});
+          std::push_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+        }
+      }
+    }
+  }
+}
+
+bool HierarchicalMap::findAbstractPath(const Map &map, std::pair<int, int> startCoords, std::pair<int, int> targetCoords, std::vector<std::pair<int, int>> &waypoints) const
+{
+  waypoints.clear();
+
+  if (startCoords.first < 0 || startCoords.first >= width || startCoords.second < 0 || startCoords.second >= height || !map.isAccessible(targetCoords.first, targetCoords.second))
+  {
+    return false;
+  }
+
+  const float infinity = std::numeric_limits<float>::infinity();
+  int startCluster = clusterAt(startCoords.first, startCoords.second);
+  int targetCluster = clusterAt(targetCoords.first, targetCoords.second);
+
+  // Connect the start and the target to the entrances of their clusters
+  std::vector<float> startCost, targetCost;
+  searchCluster(map, startCoords.first, startCoords.second, startCost);
+  searchCluster(map, targetCoords.first, targetCoords.second, targetCost);
+
+  if (startCluster == targetCluster && startCost[localIndex(targetCoords.first, targetCoords.second)] != infinity)
+  {
+    waypoints.push_back(startCoords);
+    waypoints.push_back(targetCoords);
+    return true;
+  }
+
+  // The start and the target become two temporary nodes after the real ones
+  const int startNode = nodes.size();
+  const int targetNode = startNode + 1;
+  std::vector<float> gCost(nodes.size() + 2, infinity);
+  std::vector<int> parent(nodes.size() + 2, -1);
+  std::vector<bool> closed(nodes.size() + 2, false);
+
+  auto position = [&](int node)
+  {
+    if (node == startNode)
+      return startCoords;
+    if (node == targetNode)
+      return targetCoords;
+    return std::make_pair(nodes[node].x, nodes[node].y);
+  };
+
+  // Min-heap of (f cost, node)
+  std::vector<std::pair<float, int>> open;
+  auto relax = [&](int from, int to, float edgeCost)
+  {
+    float tentative_g = gCost[from] + edgeCost;
+    if (tentative_g < gCost[to])
+    {
+      gCost[to] = tentative_g;
+      parent[to] = from;
+      std::pair<int, int> coords = position(to);
+      open.push_back({tentative_g + octileDistance(coords.first, coords.second, targetCoords.first, targetCoords.second), to});
+      std::push_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+    }
+  };
+
+  gCost[startNode] = 0;
+  open.push_back({octileDistance(startCoords.first, startCoords.second, targetCoords.first, targetCoords.second), startNode});
+
+  while (!open.empty())
+  {
+    std::pop_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+    int current = open.back().second;
+    open.pop_back();
+
+    if (closed[current])
+      continue;
+    closed[current] = true;
+
+    if (current == targetNode)
+    {
+      for (int node = targetNode; node != -1; node = parent[node])
+      {
+        // An entrance on the start or target tile would repeat it
+        if (waypoints.empty() || waypoints.back() != position(node))
+        {
+          waypoints.push_back(position(node));
+        }
+      }
+      std::reverse(waypoints.begin(), waypoints.end());
+      return true;
+    }
+
+    if (current == startNode)
+    {
+      for (int node : clusterNodes[startCluster])
+      {
+        float edgeCost = startCost[localIndex(nodes[node].x, nodes[node].y)];
+        if (edgeCost != infinity)
+          relax(current, node, edgeCost);
+      }
+      continue;
+    }
+
+    for (const auto &edge : nodes[current].edges)
+    {
+      relax(current, edge.to, edge.cost);
+    }
+
+    if (nodes[current].cluster == targetCluster)
+    {
+      float edgeCost = targetCost[localIndex(nodes[current].x, nodes[current].y)];
+      if (edgeCost != infinity)
+        relax(current, targetNode, edgeCost);
+    }
+  }
+
+  // No path found
+  return false;
+}
+
+int HierarchicalMap::getClusterSize() const { return clusterSize; }
+
+int HierarchicalMap::getNodeCount() const { return nodes.size(); }
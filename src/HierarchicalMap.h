@@ -0,0 +1,136 @@
+#ifndef HIERARCHICALMAP_H
+#define HIERARCHICALMAP_H
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+class Map;
+
+/**
+ * @class HierarchicalMap
+ * @brief Abstract graph of a map for hierarchical pathfinding (HPA*).
+ *
+ * The map is split into square clusters. Wherever two neighbouring clusters share a run of open tiles along their
+ * border, entrance nodes are placed on both sides of it (one pair in the middle of short runs, one pair at each end of
+ * long runs). Nodes of the same cluster are connected by the cost of the shortest path between them that stays inside
+ * the cluster, these costs are precomputed when the graph is built.
+ *
+ * A long path is planned on this graph as a list of waypoints, consecutive waypoints are never further apart than one
+ * cluster. The tile by tile path between two waypoints is refined only when a unit gets there.
+ *
+ * The graph doesn't keep a reference to the map it was built from, the map is passed to every query instead, so a
+ * graph can be shared between a map and its snapshots.
+ */
+class HierarchicalMap
+{
+public:
+  /**
+   * @brief Builds the abstract graph of a map.
+   *
+   * @param map The map to build the graph for.
+   * @param clusterSize The width and height of a cluster in tiles.
+   */
+  HierarchicalMap(const Map &map, int clusterSize = 16);
+
+  /**
+   * @brief Default destructor for the HierarchicalMap class.
+   */
+  ~HierarchicalMap();
+
+  /**
+   * @brief Plans a path on the abstract graph.
+   *
+   * The start and the goal are connected to the entrance nodes of their clusters for the duration of the search.
+   * If the goal can be reached from the start without leaving their common cluster, the waypoints are only the start
+   * and the goal.
+   *
+   * @param map The map the graph was built for.
+   * @param startCoords The coordinates (x, y) of the starting point.
+   * @param targetCoords The coordinates (x, y) of the target point.
+   * @param waypoints Output buffer for the waypoints from the start to the target. Left empty if no path is found.
+   * @return bool True if a path was found, false otherwise.
+   */
+  bool findAbstractPath(const Map &map, std::pair<int, int> startCoords, std::pair<int, int> targetCoords, std::vector<std::pair<int, int>> &waypoints) const;
+
+  /**
+   * @brief Returns the width and height of a cluster in tiles.
+   *
+   * @return int The cluster size.
+   */
+  int getClusterSize() const;
+
+  /**
+   * @brief Returns the number of entrance nodes in the abstract graph.
+   *
+   * @return int The number of nodes.
+   */
+  int getNodeCount() const;
+
+private:
+  /**
+   * @struct Edge
+   * @brief Connection between two abstract nodes.
+   */
+  struct Edge
+  {
+    int to;
+    float cost;
+  };
+
+  /**
+   * @struct Node
+   * @brief Entrance tile on the border of a cluster.
+   */
+  struct Node
+  {
+    int x, y;
+    int cluster;
+    std::vector<Edge> edges;
+  };
+
+  /**
+   * @brief Returns the index of the cluster containing a tile.
+   */
+  int clusterAt(int x, int y) const;
+
+  /**
+   * @brief Returns the node placed on a tile, creating it if there is none.
+   */
+  int nodeAt(int x, int y);
+
+  /**
+   * @brief Places entrance nodes along a border run of open tiles and connects the two sides.
+   *
+   * @param x The x-coordinate of the first tile of the run on the near side.
+   * @param y The y-coordinate of the first tile of the run on the near side.
+   * @param length The number of tiles in the run.
+   * @param vertical True if the run goes down a vertical border, false if it goes along a horizontal one.
+   */
+  void addEntrance(int x, int y, int length, bool vertical);
+
+  /**
+   * @brief Finds the costs from a tile to every tile of its cluster without leaving the cluster.
+   *
+   * @param map The map the graph was built for.
+   * @param startX The x-coordinate of the tile.
+   * @param startY The y-coordinate of the tile.
+   * @param cost Output buffer indexed by tile within the cluster, unreachable tiles are infinite.
+   */
+  void searchCluster(const Map &map, int startX, int startY, std::vector<float> &cost) const;
+
+  /**
+   * @brief Returns the index of a tile within its cluster.
+   */
+  int localIndex(int x, int y) const;
+
+  int width, height;
+  int clusterSize;
+  int clustersX, clustersY;
+
+  std::vector<Node> nodes;
+  std::vector<std::vector<int>> clusterNodes;
+  std::unordered_map<int, int> nodeByTile;
+};
+
+#endif
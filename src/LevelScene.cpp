@@ -12,16 +12,65 @@
 #include "Player.h"
 #include "GameObject.h"
 #include "TextButton.h"
+#include "Profiler.h"
+#include "FramePacer.h"
 
 std::unique_ptr<Map> LevelScene::map = nullptr;
-
-LevelScene::LevelScene(const std::pair<std::string, std::string> &levelData) : name(levelData.first), gameOver(false), playerWon(false)
+std::unique_ptr<PathQueue> LevelScene::pathQueue = nullptr;
+std::unique_ptr<ThreadPool> LevelScene::threadPool = nullptr;
+UnitStore LevelScene::unitStore;
+SpatialGrid LevelScene::unitGrid;
+SpatialGrid LevelScene::resourceGrid;
+CollisionMap LevelScene::collisionMap;
+Arena *LevelScene::levelArena = nullptr;
+Arena LevelScene::frameArena(16 * 1024);
+
+LevelScene::LevelScene(const std::pair<std::string, std::string> &levelData) : name(levelData.first), gameOver(false), playerWon(false), staticLayer(nullptr), staticLayerValid(false), simulationRunning(false), endMenuVisible(false)
 {
+  levelArena = &arena;
+
   if (!map)
   {
     map = std::make_unique<Map>();
   }
 
+  talentsVisible = false;
+  endMessage = nullptr;
+
+  // Headless matches have no window to show menus in
+  if (!Game::headless)
+  {
+    createMenus();
+  }
+
+  success = loadLevel(levelData.second);
+
+  state = Game::save.getLevelState(levelData.first);
+  updateState();
+
+  // Something to draw before the first tick
+  if (success && !Game::headless)
+  {
+    publishSnapshot();
+  }
+}
+
+LevelScene::~LevelScene()
+{
+  stopSimulation();
+
+  if (levelArena == &arena)
+    levelArena = nullptr;
+
+  if (staticLayer)
+  {
+    SDL_DestroyTexture(staticLayer);
+    staticLayer = nullptr;
+  }
+}
+
+void LevelScene::createMenus()
+{
   SDL_Texture *tilesetTexture = Game::resourceManager.loadTexture("./assets/grass_tileset_16x16.png");
 
   int windowWidth, windowHeight;
@@ -35,14 +84,16 @@ LevelScene::LevelScene(const std::pair<std::string, std::string> &levelData) : n
     Game::changeState(GameState::LEVEL_SELECT);
   };
 
-  talentsVisible = false;
+  // Both read the state of the simulation, they wait for the tick that is running to finish
   std::function<void()> toggleTalentsVisible = [this]()
   {
+    std::lock_guard<std::mutex> lock(simulationMutex);
     talentsVisible = !talentsVisible;
   };
 
   std::function<void()> saveProgress = [this]()
   {
+    std::lock_guard<std::mutex> lock(simulationMutex);
     saveCurrentLevel();
   };
 
@@ -64,11 +115,6 @@ LevelScene::LevelScene(const std::pair<std::string, std::string> &levelData) : n
   endMessage = endMenu->addTextAndGet(std::move(textElement));
 
   endMenu->addTextButton((windowWidth - 300) / 2, (windowHeight - 50) / 2, 300, 50, "BACK TO LEVELS", "./assets/empire.ttf", 24, {255, 255, 255, 255}, {0, 0, 0, 0}, {127, 127, 127, 255}, {255, 255, 255, 255}, {255, 255, 255, 255}, backAction);
-
-  success = loadLevel(levelData.second);
-
-  state = Game::save.getLevelState(levelData.first);
-  updateState();
 }
 
 bool LevelScene::loadLevel(const std::string &levelFilePath)
@@ -134,6 +180,13 @@ bool LevelScene::loadLevel(const std::string &levelFilePath)
   }
   levelFileStream.close();
 
+  if (mapData.empty())
+  {
+    printf("The map file contains no rows. Game will stop running.\n");
+    Game::isRunning = false;
+    return false;
+  }
+
   for (const auto &c : mapData.back())
   {
     if (c != 'W')
@@ -150,19 +203,19 @@ bool LevelScene::loadLevel(const std::string &levelFilePath)
     return false;
   }
 
-  const int expectedRows = 32;
-  const int expectedColumns = 50;
-  if (mapData.size() != expectedRows)
+  // The map size is given by the file, every row has to be as long as the first one
+  const size_t columns = mapData[0].size();
+  if (mapData.size() < 3 || columns < 3)
   {
-    printf("Invalid number of rows in the map file. Expected %d rows, but found %zu rows. Game will stop running.\n", expectedRows, mapData.size());
+    printf("The map is too small, it has %zu rows and %zu columns. Game will stop running.\n", mapData.size(), columns);
     Game::isRunning = false;
     return false;
   }
   for (const auto &row : mapData)
   {
-    if (row.size() != expectedColumns)
+    if (row.size() != columns)
     {
-      printf("Invalid number of columns in a row of the map file. Expected %d columns, but found %zu columns. Game will stop running.\n", expectedColumns, row.size());
+      printf("Invalid number of columns in a row of the map file. Expected %zu columns, but found %zu columns. Game will stop running.\n", columns, row.size());
       Game::isRunning = false;
       return false;
     }
@@ -183,6 +236,16 @@ bool LevelScene::loadLevel(const std::string &levelFilePath)
 
   map->load(mapData);
 
+  // Paths are searched on worker threads against a snapshot of the loaded grid
+  pathQueue = std::make_unique<PathQueue>(map->snapshot());
+
+  // The units are updated on a pool kept for the whole game
+  if (!threadPool)
+    threadPool = std::make_unique<ThreadPool>();
+
+  unitGrid.setArea(0, 88, map->getWidth() * 16, map->getHeight() * 16);
+  resourceGrid.setArea(0, 88, map->getWidth() * 16, map->getHeight() * 16);
+
   int y = 0;
 
   int aiIdCounter = 1;
@@ -234,18 +297,35 @@ bool LevelScene::loadLevel(const std::string &levelFilePath)
 
           if (row[x] == 'T')
           {
-            allResources.push_back(std::make_unique<Resource>(x * 16, 88 + y * 16, 32, 32, "wood"));
+            allResources.push_back(std::make_unique<Resource>(x * 16, 88 + y * 16, 32, 32, WOOD));
           }
 
           if (row[x] == 'C')
           {
-            allResources.push_back(std::make_unique<Resource>(x * 16, 88 + y * 16, 32, 32, "crystals"));
+            allResources.push_back(std::make_unique<Resource>(x * 16, 88 + y * 16, 32, 32, CRYSTALS));
           }
         }
       }
     }
     y++;
   }
+
+  resourceGrid.build(allResources);
+
+  // Static objects never move, units test against their raster instead of every object
+  collisionMap.reset(0, 88, map->getWidth(), map->getHeight());
+  for (auto &wall : allWalls)
+  {
+    collisionMap.block(wall->getRect());
+  }
+  for (auto &castle : allCastles)
+  {
+    collisionMap.block(castle->getRect());
+  }
+  for (auto &resource : allResources)
+  {
+    collisionMap.block(resource->getRect());
+  }
   return true;
 }
 
@@ -425,40 +505,43 @@ void LevelScene::saveCurrentLevel()
 
 void LevelScene::update()
 {
+  PROFILE_SCOPE("LevelScene::update");
   if (!success)
     return;
 
+  frameArena.reset();
+
+  // Positions at the start of the tick, rendering interpolates from them
+  unitStore.savePreviousPositions();
+
   if (!gameOver)
   {
-    levelMenu->update();
+    if (player)
+      player->applyCommands();
+
+    // Apply the paths solved since the last frame, the rest waits for the next one
+    pathQueue->collect(pathResults, pathResultBudget);
+    for (auto &result : pathResults)
+    {
+      if (Unit *unit = unitStore.get(result.unit))
+        unit->applyPathResult(result.ticket, result.path, result.waypoints);
+    }
 
     if (!talentsVisible)
     {
-      for (auto &unit : allUnits)
-      {
-        unit->update();
-      }
+      // Every step runs for all units on the thread pool before the next one, each walking the columns of the unit store
+      // it needs
+      unitGrid.build(unitStore.rects);
+      unitStore.followPaths(*threadPool);
+      unitStore.separateAll(unitGrid, *threadPool);
+      unitStore.applyForces(*threadPool);
+      unitStore.interactAll(Game::tick, *threadPool);
 
       if (player)
       {
         player->getCastle().update();
         if (!player->getCastle().isAlive())
         {
-
-          std::unique_ptr<Text> textElement = std::make_unique<Text>("You Lost!", "./assets/go3v2.ttf", 36, SDL_Color{255, 255, 255, 255}, 0, 0);
-
-          SDL_Rect textDimensions = textElement->getDimensions();
-          SDL_Rect endMessageDimension = endMessage->getDimensions();
-
-          int windowWidth, windowHeight;
-          SDL_GetWindowSize(Game::window, &windowWidth, &windowHeight);
-
-          int textX = (windowWidth - textDimensions.w) / 2;
-          int textY = 80 + endMessageDimension.h;
-          textElement->setPosition(textX, textY);
-
-          endMenu->addText(std::move(textElement));
-
           gameOver = true;
         }
       }
@@ -472,77 +555,230 @@ void LevelScene::update()
       }
       if (allAIsDead)
       {
-        endMessage->setText("Victory!");
-        int windowWidth, windowHeight;
-        SDL_GetWindowSize(Game::window, &windowWidth, &windowHeight);
-
-        SDL_Rect endMessageDimension = endMessage->getDimensions();
-        endMessage->setPosition((windowWidth - endMessageDimension.w) / 2, 80);
-
+        playerWon = true;
         gameOver = true;
       }
     }
 
-    for (auto &unit : unitsToRemove)
+    // allUnits is kept in the order of the store slots, so both are swapped and popped the same way. A unit that died
+    // twice this tick has a stale handle by its second entry.
+    for (UnitHandle handle : unitsToRemove)
     {
-      allUnits.erase(std::remove_if(allUnits.begin(), allUnits.end(),
-                                    [&unit](const std::unique_ptr<Unit> &u)
-                                    { return u.get() == unit; }),
-                     allUnits.end());
+      Unit *unit = unitStore.get(handle);
+      if (unit == nullptr)
+        continue;
+
+      std::swap(allUnits[unit->getSlot()], allUnits.back());
+      allUnits.pop_back();
     }
 
     if (player)
     {
       auto &selectedUnits = player->getSelectedUnits();
-      selectedUnits.erase(
-          std::remove_if(selectedUnits.begin(), selectedUnits.end(),
-                         [this](Unit *unit)
-                         {
-                           return std::none_of(allUnits.begin(), allUnits.end(),
-                                               [unit](const std::unique_ptr<Unit> &u)
-                                               { return u.get() == unit; });
-                         }),
-          selectedUnits.end());
-      player->update();
+      selectedUnits.erase(std::remove_if(selectedUnits.begin(), selectedUnits.end(),
+                                         [](UnitHandle handle)
+                                         { return !unitStore.isValid(handle); }),
+                          selectedUnits.end());
     }
 
     unitsToRemove.clear();
   }
-  else
+
+  if (!Game::headless)
+  {
+    publishSnapshot();
+  }
+}
+
+void LevelScene::publishSnapshot()
+{
+  RenderSnapshot &snapshot = snapshots.write();
+  snapshot.clear();
+
+  // The same order the layers are drawn in, the player's castle first
+  if (player)
+  {
+    snapshot.castles.emplace_back();
+    player->getCastle().capture(snapshot.castles.back());
+  }
+  for (auto &ai : ais)
+  {
+    snapshot.castles.emplace_back();
+    ai->getCastle().capture(snapshot.castles.back());
+  }
+
+  snapshot.units.resize(allUnits.size());
+  for (size_t i = 0; i < allUnits.size(); ++i)
+  {
+    allUnits[i]->capture(snapshot.units[i]);
+  }
+
+  snapshot.wood = player ? player->getWood() : 0;
+  snapshot.crystals = player ? player->getCrystals() : 0;
+  snapshot.controlling = player && player->isControllingUnits();
+  snapshot.gameOver = gameOver;
+  snapshot.playerWon = playerWon;
+  snapshot.tick = Game::tick;
+  snapshot.publishedAt = SDL_GetPerformanceCounter();
+
+  snapshots.publish();
+}
+
+void LevelScene::startSimulation()
+{
+  if (!success || Game::headless || simulationThread.joinable())
+    return;
+
+  simulationRunning = true;
+  simulationThread = std::thread(&LevelScene::runSimulation, this);
+}
+
+void LevelScene::stopSimulation()
+{
+  simulationRunning = false;
+  if (simulationThread.joinable())
+    simulationThread.join();
+}
+
+void LevelScene::runSimulation()
+{
+  FramePacer pacer;
+  pacer.setFrameRate(Game::ticksPerSecond);
+
+  while (simulationRunning)
+  {
+    {
+      std::lock_guard<std::mutex> lock(simulationMutex);
+      update();
+      Game::tick++;
+    }
+    pacer.wait();
+  }
+}
+
+void LevelScene::updateInterface()
+{
+  if (!success || Game::headless)
+    return;
+
+  const RenderSnapshot &snapshot = snapshots.read();
+
+  if (snapshot.gameOver && !endMenuVisible)
+  {
+    showEndMessage(snapshot.playerWon);
+    endMenuVisible = true;
+  }
+
+  if (endMenuVisible)
   {
     endMenu->update();
+    return;
   }
+
+  levelMenu->update();
+  if (player)
+    player->updateInterface(snapshot);
 }
 
-void LevelScene::render()
+void LevelScene::showEndMessage(bool won)
 {
-  if (!success)
+  int windowWidth, windowHeight;
+  SDL_GetWindowSize(Game::window, &windowWidth, &windowHeight);
+
+  if (won)
+  {
+    endMessage->setText("Victory!");
+    SDL_Rect endMessageDimension = endMessage->getDimensions();
+    endMessage->setPosition((windowWidth - endMessageDimension.w) / 2, 80);
     return;
+  }
+
+  std::unique_ptr<Text> textElement = std::make_unique<Text>("You Lost!", "./assets/go3v2.ttf", 36, SDL_Color{255, 255, 255, 255}, 0, 0);
+
+  SDL_Rect textDimensions = textElement->getDimensions();
+  SDL_Rect endMessageDimension = endMessage->getDimensions();
+
+  int textX = (windowWidth - textDimensions.w) / 2;
+  int textY = 80 + endMessageDimension.h;
+  textElement->setPosition(textX, textY);
+
+  endMenu->addText(std::move(textElement));
+}
+
+bool LevelScene::bakeStaticLayer()
+{
+  if (!staticLayer)
+  {
+    int windowWidth, windowHeight;
+    SDL_GetWindowSize(Game::window, &windowWidth, &windowHeight);
+    staticLayer = SDL_CreateTexture(Game::renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, windowWidth, windowHeight);
+    if (staticLayer == nullptr)
+      return false;
+  }
+
+  SDL_SetRenderTarget(Game::renderer, staticLayer);
+  SDL_SetRenderDrawColor(Game::renderer, 0, 0, 0, 255);
+  SDL_RenderClear(Game::renderer);
 
   levelMenu->renderBackground();
 
+  spriteBatch.begin(Game::resourceManager.getAtlas());
+
   for (auto &wall : allWalls)
   {
-    wall->render();
+    wall->draw(spriteBatch);
   }
 
-  player->getCastle().render();
-
   for (auto &resource : allResources)
   {
-    resource->render();
+    resource->draw(spriteBatch);
   }
 
-  for (auto &ai : ais)
+  spriteBatch.flush();
+
+  SDL_SetRenderTarget(Game::renderer, NULL);
+  staticLayerValid = true;
+  return true;
+}
+
+void LevelScene::render()
+{
+  if (!success)
+    return;
+
+  const RenderSnapshot &snapshot = snapshots.read();
+
+  if (!staticLayerValid)
+    bakeStaticLayer();
+
+  // The background, walls and resources never change while playing, they are copied from the baked layer
+  spriteBatch.begin(Game::resourceManager.getAtlas());
+
+  if (staticLayerValid)
   {
-    ai->render();
+    SDL_RenderCopy(Game::renderer, staticLayer, NULL, NULL);
   }
-
-  for (auto &unit : allUnits)
+  else
   {
-    unit->render();
+    levelMenu->renderBackground();
+
+    for (auto &wall : allWalls)
+    {
+      wall->draw(spriteBatch);
+    }
+
+    for (auto &resource : allResources)
+    {
+      resource->draw(spriteBatch);
+    }
   }
 
+  // The castles and units come from the newest snapshot, drawn the part of a tick that passed since it was published
+  double ticksSincePublished = static_cast<double>(SDL_GetPerformanceCounter() - snapshot.publishedAt) / SDL_GetPerformanceFrequency() * Game::ticksPerSecond;
+  snapshot.draw(spriteBatch, static_cast<float>(std::min(ticksSincePublished, 1.0)));
+
+  spriteBatch.flush();
+
   if (player)
   {
     player->render();
@@ -550,7 +786,7 @@ void LevelScene::render()
 
   levelMenu->render();
 
-  if (gameOver)
+  if (endMenuVisible)
   {
     endMenu->renderBackground();
     endMenu->render();
@@ -562,9 +798,18 @@ void LevelScene::handleInput(SDL_Event &event)
   if (!success)
     return;
 
-  if (player && !gameOver)
+  if (player && !endMenuVisible)
   {
-    player->handleInput(event);
+    // Buying talents changes the multipliers and resources of the simulation, it waits for the running tick
+    if (talentsVisible)
+    {
+      std::lock_guard<std::mutex> lock(simulationMutex);
+      player->handleInput(event);
+    }
+    else
+    {
+      player->handleInput(event);
+    }
   }
 
   switch (event.type)
@@ -572,13 +817,18 @@ void LevelScene::handleInput(SDL_Event &event)
   case SDL_QUIT:
     Game::isRunning = false;
     break;
+  case SDL_RENDER_TARGETS_RESET:
+  case SDL_RENDER_DEVICE_RESET:
+    // Some renderers lose the content of target textures, the static layer has to be drawn again
+    invalidateStaticLayer();
+    break;
   case SDL_MOUSEBUTTONUP:
     if (event.button.button == SDL_BUTTON_LEFT)
     {
       int mouseX = event.button.x;
       int mouseY = event.button.y;
 
-      if (!gameOver)
+      if (!endMenuVisible)
       {
         levelMenu->handleClick(mouseX, mouseY);
       }
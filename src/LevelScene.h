@@ -7,14 +7,26 @@
 #include "LevelState.h"
 #include "Menu.h"
 #include "Map.h"
+#include "PathQueue.h"
+#include "ThreadPool.h"
+#include "Arena.h"
+#include "SpatialGrid.h"
+#include "CollisionMap.h"
+#include "UnitStore.h"
 #include "Wall.h"
 #include "Text.h"
 #include "Castle.h"
+#include "SpriteBatch.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
 #include <string>
 #include <memory>
 #include <utility>
 #include <vector>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 /**
  * @class LevelScene
@@ -24,6 +36,11 @@
  * loading and validating level data, updating the game state, rendering game objects, handling user input,
  * and managing menus and end-game conditions. It encapsulates the behavior and components of a level,
  * including the map, players, AI, units, castles, resources, menus, and end-game messages.
+ *
+ * While a level is played in a window, the simulation runs on a thread of its own at the fixed tick rate. It publishes
+ * a render snapshot after every tick, the render thread draws the newest one and keeps the menus up to date. Orders
+ * of the player reach the simulation as commands, the rare menu actions that change its state wait for the running
+ * tick to finish.
  */
 class LevelScene
 {
@@ -41,8 +58,17 @@ public:
   /**
    * @brief Destroys the Level Scene object
    *
+   * The simulation thread is stopped first. Units still alive give their memory back to the arena of this level before
+   * it is freed.
+   */
+  ~LevelScene();
+
+  /**
+   * @brief Creates the level menu and the end game menu.
+   *
+   * Called by the constructor unless the game runs headless.
    */
-  ~LevelScene() = default;
+  void createMenus();
 
   /**
    * @brief Loads a level from a text file and initializes the map.
@@ -69,6 +95,16 @@ public:
    */
   bool isAreaValid(int topLeftX, int topLeftY, int size, char expectedCharacter);
 
+  /**
+   * @brief Draws the background, walls and resources into the static layer texture.
+   *
+   * The texture is created on the first bake and covers the whole window. If it cannot be created, render draws the
+   * static objects directly every frame instead.
+   *
+   * @return True if the static layer was baked; otherwise, false.
+   */
+  bool bakeStaticLayer();
+
   /**
    * @brief Updates the state of the level based on loaded game state.
    *
@@ -86,21 +122,52 @@ public:
   void saveCurrentLevel();
 
   /**
-   * @brief Updates the level scene in each frame of the game.
+   * @brief Runs one tick of the level simulation.
    *
-   * This function controls the game's state, updates the states of all objects in the level, and determines whether the player has won or lost.
-   * If the game is over, it prepares and shows the appropriate end game message.
+   * This function carries out the queued player commands, updates the states of all objects in the level, and determines whether the player has won or lost.
+   * Unless the game runs headless, the result is published as a render snapshot. Runs on the simulation thread once
+   * it is started, otherwise on the thread calling it.
    */
   void update();
 
+  /**
+   * @brief Starts running update on the simulation thread at the fixed tick rate.
+   *
+   * Does nothing if the level did not load, the game runs headless, or the simulation already runs.
+   */
+  void startSimulation();
+
+  /**
+   * @brief Stops the simulation thread after the tick it is running and waits for it.
+   *
+   * Must not be called while holding the simulation lock, so not from inside a menu action that takes it.
+   */
+  void stopSimulation();
+
+  /**
+   * @brief Updates the menus on the render thread from the newest render snapshot.
+   *
+   * If the snapshot shows the game is over, it prepares and shows the appropriate end game message.
+   */
+  void updateInterface();
+
   /**
    * @brief Renders the level scene.
    *
    * This function controls the drawing of all objects in the level scene including walls, resources, AI, units, and player.
-   * It also renders the menus according to the game's state.
+   * It also renders the menus according to the game's state. The background, walls and resources come from the static
+   * layer, which is baked again first if it was invalidated. Castles and units are drawn from the newest render
+   * snapshot, so rendering never reads the state the simulation is changing.
    */
   void render();
 
+  /**
+   * @brief Marks the static layer as outdated, it is baked again before the next frame is drawn.
+   *
+   * Has to be called whenever the background, a wall or a resource changes after the level was loaded.
+   */
+  void invalidateStaticLayer() { staticLayerValid = false; };
+
   /**
    * @brief Handles the input for the level scene.
    *
@@ -112,6 +179,27 @@ public:
    */
   void handleInput(SDL_Event &event);
 
+  /**
+   * @brief Checks whether the level was loaded successfully.
+   *
+   * @return True if the level file was valid and the level can be played; otherwise, false.
+   */
+  bool isLoaded() const { return success; };
+
+  /**
+   * @brief Checks whether the game in this level has ended.
+   *
+   * @return True if the player's castle or all AI castles were destroyed; otherwise, false.
+   */
+  bool isGameOver() const { return gameOver; };
+
+  /**
+   * @brief Checks whether the player won the level.
+   *
+   * @return True if all AI castles were destroyed; otherwise, false.
+   */
+  bool hasPlayerWon() const { return playerWon; };
+
   /**
    * @brief Gets the map of the level scene.
    *
@@ -121,9 +209,100 @@ public:
    */
   static Map &getMap() { return *map; };
 
+  /**
+   * @brief Gets the path queue of the level scene.
+   *
+   * Units request their paths here, the results are applied at the start of the next update.
+   *
+   * @return A reference to the path queue of the level scene.
+   */
+  static PathQueue &getPathQueue() { return *pathQueue; };
+
+  /**
+   * @brief Gets the store of the simulation state of all units.
+   *
+   * @return A reference to the unit store.
+   */
+  static UnitStore &getUnitStore() { return unitStore; };
+
+  /**
+   * @brief Gets the spatial grid of all units.
+   *
+   * The grid is rebuilt at the start of every update, its indexes are slots of the unit store.
+   *
+   * @return A reference to the spatial grid of the units.
+   */
+  static const SpatialGrid &getUnitGrid() { return unitGrid; };
+
+  /**
+   * @brief Gets the spatial grid of all resources.
+   *
+   * The grid is built when the level is loaded, its indexes refer to the vector of all resources.
+   *
+   * @return A reference to the spatial grid of the resources.
+   */
+  static const SpatialGrid &getResourceGrid() { return resourceGrid; };
+
+  /**
+   * @brief Gets the collision map of the static objects of the level.
+   *
+   * The walls, castles and resources are rasterized into it when the level is loaded.
+   *
+   * @return A reference to the collision map of the level.
+   */
+  static CollisionMap &getCollisionMap() { return collisionMap; };
+
+  /**
+   * @brief Gets the arena of the level that is being played.
+   *
+   * Units are allocated in it and it is freed together with the level. A new level takes over before the old one is
+   * destroyed, units of the old level still go back to the arena they came from.
+   *
+   * @return A reference to the arena of the level.
+   */
+  static Arena &getLevelArena() { return *levelArena; };
+
+  /**
+   * @brief Gets the arena for scratch data of the current tick.
+   *
+   * The arena is reset at the start of every update, nothing allocated in it may be kept for the next tick.
+   *
+   * @return A reference to the frame arena.
+   */
+  static Arena &getFrameArena() { return frameArena; };
+
 private:
+  /**
+   * @brief Copies the castles, units and player state into a render snapshot and hands it to the render thread.
+   */
+  void publishSnapshot();
+
+  /**
+   * @brief Runs ticks until the simulation is stopped, the body of the simulation thread.
+   */
+  void runSimulation();
+
+  /**
+   * @brief Fills the end menu with the message for a won or lost level.
+   *
+   * @param won True if the player destroyed all AI castles.
+   */
+  void showEndMessage(bool won);
+
+  // Declared first so it is destroyed after everything allocated in it
+  Arena arena;
+  static Arena *levelArena;
+  static Arena frameArena;
   std::string name;
   static std::unique_ptr<Map> map;
+  static std::unique_ptr<PathQueue> pathQueue;
+  static std::unique_ptr<ThreadPool> threadPool;
+  std::vector<PathQueue::Result> pathResults;
+  static const size_t pathResultBudget = 64;
+  static UnitStore unitStore;
+  static SpatialGrid unitGrid;
+  static SpatialGrid resourceGrid;
+  static CollisionMap collisionMap;
   std::vector<std::string> mapData;
   bool success;
   std::unique_ptr<Menu> levelMenu;
@@ -132,12 +311,21 @@ private:
   bool gameOver;
   bool playerWon;
   Text *endMessage;
+  SpriteBatch spriteBatch;
+  SDL_Texture *staticLayer;
+  bool staticLayerValid;
+
+  TripleBuffer<RenderSnapshot> snapshots;
+  std::mutex simulationMutex;
+  std::thread simulationThread;
+  std::atomic<bool> simulationRunning;
+  bool endMenuVisible;
 
   std::unique_ptr<Player> player;
   std::vector<std::unique_ptr<AI>> ais;
 
   std::vector<std::unique_ptr<Unit>> allUnits;
-  std::vector<Unit *> unitsToRemove;
+  std::vector<UnitHandle> unitsToRemove;
   std::vector<std::unique_ptr<Wall>> allWalls;
   std::vector<std::unique_ptr<Resource>> allResources;
   std::vector<Castle *> allCastles;
@@ -1,6 +1,7 @@
 #ifndef LEVELSTATE_H
 #define LEVELSTATE_H
 
+#include "UnitTypes.h"
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,7 +28,7 @@ public:
   {
     int ownerId;
     int health;
-    std::string type;
+    UnitType type;
     std::pair<int, int> coords;
   };
 
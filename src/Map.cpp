@@ -1,45 +1,178 @@
 #include "Map.h"
 #include "AStar.h"
+#include "FlowField.h"
+#include "HierarchicalMap.h"
 #include <utility>
 #include <list>
+#include <algorithm>
+#include <cmath>
 
-Map::Map() = default;
+Map::Map() : width(0), height(0), pathfindingMode(JUMP_POINT) {}
+
+Map::Map(const Map &other) : grid(other.grid), width(other.width), height(other.height), pathfindingMode(other.pathfindingMode), hierarchy(other.hierarchy) {}
 
 Map::~Map() = default;
 
-std::list<std::pair<int, int>> Map::calculatePath(std::pair<int, int> startCoords, std::pair<int, int> targetCoords)
+std::shared_ptr<const Map> Map::snapshot() const
 {
-  AStar pathFinder(*this);                                                                                                                       // Vytvoříme instanci AStar s danou mapou
-  std::vector<std::pair<int, int>> pathVec = pathFinder.getPath(startCoords.first, startCoords.second, targetCoords.first, targetCoords.second); // Vypočteme cestu
-  std::list<std::pair<int, int>> path(pathVec.begin(), pathVec.end());                                                                           // Převedeme vektor na list
-  return path;
+  return std::make_shared<const Map>(*this);
+}
+
+void Map::calculatePath(std::pair<int, int> startCoords, std::pair<int, int> targetCoords, WaypointBuffer &path)
+{
+  if (!pathFinder)
+  {
+    pathFinder = std::make_unique<AStar>(*this); // The search buffers are created once and reused by every search
+  }
+  if (pathfindingMode == JUMP_POINT)
+  {
+    pathFinder->findJumpPointPath(startCoords.first, startCoords.second, targetCoords.first, targetCoords.second, pathBuffer);
+  }
+  else if (pathfindingMode == THETA_STAR)
+  {
+    pathFinder->findThetaStarPath(startCoords.first, startCoords.second, targetCoords.first, targetCoords.second, pathBuffer);
+  }
+  else
+  {
+    pathFinder->findPath(startCoords.first, startCoords.second, targetCoords.first, targetCoords.second, pathBuffer); // Vypočteme cestu
+  }
+  smoothPath(pathBuffer, path);
+}
+
+bool Map::hasLineOfSight(int fromX, int fromY, int toX, int toY) const
+{
+  // The unit square is shrunk a little, so sliding along the edge of a blocked tile doesn't count as entering it
+  const double shrink = 1e-6;
+  int dx = toX - fromX;
+  int dy = toY - fromY;
+
+  // Every column the square overlaps, with the rows it overlaps while it is in that column
+  for (int column = std::min(fromX, toX); column <= std::max(fromX, toX); ++column)
+  {
+    double enter = 0.0;
+    double leave = 1.0;
+    if (dx != 0)
+    {
+      double first = (column - 1 + shrink - fromX) / dx;
+      double second = (column + 1 - shrink - fromX) / dx;
+      enter = std::max(0.0, std::min(first, second));
+      leave = std::min(1.0, std::max(first, second));
+    }
+
+    double enterY = fromY + enter * dy;
+    double leaveY = fromY + leave * dy;
+    int firstRow = static_cast<int>(std::floor(std::min(enterY, leaveY) - 1 + shrink)) + 1;
+    int lastRow = static_cast<int>(std::ceil(std::max(enterY, leaveY) + 1 - shrink)) - 1;
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+      if (!grid.get(column, row))
+        return false;
+    }
+  }
+  return true;
+}
+
+void Map::smoothPath(const std::vector<std::pair<int, int>> &tiles, WaypointBuffer &path) const
+{
+  thread_local WaypointBuffer corners;
+  corners.clear();
+  for (const auto &tile : tiles)
+  {
+    corners.pushCorner(tile);
+  }
+  smoothPath(corners, path);
+}
+
+void Map::smoothPath(const WaypointBuffer &corners, WaypointBuffer &path) const
+{
+  path.clear();
+  if (corners.empty())
+    return;
+
+  // Pull the path tight: a corner is only needed if the last kept one can't see the corner after it
+  size_t anchor = 0;
+  path.pushBack(corners.front());
+  for (size_t i = 1; i + 1 < corners.size(); ++i)
+  {
+    const auto &from = corners[anchor];
+    const auto &to = corners[i + 1];
+    if (!hasLineOfSight(from.first, from.second, to.first, to.second))
+    {
+      path.pushBack(corners[i]);
+      anchor = i;
+    }
+  }
+  if (corners.size() > 1)
+  {
+    path.pushBack(corners.back());
+  }
+}
+
+std::shared_ptr<const FlowField> Map::getFlowField(int goalX, int goalY, int goalWidth, int goalHeight)
+{
+  for (auto it = flowFields.begin(); it != flowFields.end(); ++it)
+  {
+    if ((*it)->hasGoal(goalX, goalY, goalWidth, goalHeight))
+    {
+      // Move the field to the front, the back holds the least recently used one
+      flowFields.splice(flowFields.begin(), flowFields, it);
+      return flowFields.front();
+    }
+  }
+
+  flowFields.push_front(std::make_shared<FlowField>(*this, goalX, goalY, goalWidth, goalHeight));
+  if (flowFields.size() > flowFieldCacheSize)
+  {
+    flowFields.pop_back();
+  }
+  return flowFields.front();
 }
 
 void Map::load(const std::vector<std::string> &mapData)
 {
-  int height = mapData.size();
-  int width = mapData[0].length();
-  grid = std::vector<std::vector<bool>>(height, std::vector<bool>(width, true));
+  flowFields.clear();
+  height = mapData.size();
+  width = mapData[0].length();
+  grid.reset(width, height);
 
   for (int y = 0; y < height; ++y)
   {
     for (int x = 0; x < width; ++x)
     {
-      if (mapData[y][x] == 'C' || mapData[y][x] == 'T' || mapData[y][x] == 'W' || mapData[y][x] == 'P' || mapData[y][x] == 'X')
+      if (mapData[y][x] != 'C' && mapData[y][x] != 'T' && mapData[y][x] != 'W' && mapData[y][x] != 'P' && mapData[y][x] != 'X')
       {
-        grid[y][x] = false;
+        grid.set(x, y, true);
       }
     }
   }
+
+  // Plain searches don't scale to big maps, long paths there are planned on the hierarchical graph
+  hierarchy.reset();
+  if (width >= hierarchyMinSize || height >= hierarchyMinSize)
+  {
+    hierarchy = std::make_shared<HierarchicalMap>(*this);
+  }
 }
 
 bool Map::isAccessible(int x, int y) const
 {
   // Check that coordinates are within the grid bounds
-  if (x < 0 || x >= 50 || y < 0 || y >= 32)
+  if (x < 0 || x >= width || y < 0 || y >= height)
   {
     return false;
   }
 
-  return grid[y][x];
+  return grid.get(x, y);
 }
+
+const BitGrid &Map::getGrid() const { return grid; }
+
+const HierarchicalMap *Map::getHierarchy() const { return hierarchy.get(); }
+
+void Map::setPathfindingMode(PathfindingMode mode) { pathfindingMode = mode; }
+
+PathfindingMode Map::getPathfindingMode() const { return pathfindingMode; }
+
+int Map::getWidth() const { return width; }
+
+int Map::getHeight() const { return height; }
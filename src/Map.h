@@ -5,14 +5,35 @@
 #include <string>
 #include <list>
 #include <utility>
+#include <memory>
+#include "BitGrid.h"
+#include "WaypointBuffer.h"
+
+class AStar;
+class FlowField;
+class HierarchicalMap;
+
+/**
+ * @enum PathfindingMode
+ * @brief Selects the search algorithm used by Map::calculatePath.
+ *
+ * Every mode ends up in the same format, the corners of the path after string pulling.
+ */
+enum PathfindingMode
+{
+  ASTAR,      /**< Plain A* search that expands every reachable neighbour. */
+  JUMP_POINT, /**< Jump Point Search, only expands jump points. Suited for uniform-cost grids like the level maps. */
+  THETA_STAR  /**< Any-angle Theta*, cells link to any cell in line of sight, so paths are not bound to 8 directions. */
+};
 
 /**
  * @class Map
  * @brief Represents the game map.
  *
  * The Map class is responsible for managing the game map and providing operations related to the map,
- * such as loading map data, checking accessibility of coordinates, and calculating paths using the A* algorithm.
- * It uses a grid representation to store information about each cell in the map.
+ * such as loading map data, checking accessibility of coordinates, and calculating paths using the A* algorithm
+ * or Jump Point Search.
+ * It uses a grid representation to store information about each cell in the map, one bit per cell.
  */
 class Map
 {
@@ -22,6 +43,16 @@ public:
    */
   Map();
 
+  /**
+   * @brief Copy constructor for the Map class.
+   *
+   * Copies the map grid and the pathfinding mode and shares the hierarchical graph. The search buffers and the flow
+   * field cache are not copied, the copy creates its own on first use.
+   *
+   * @param other The map to copy.
+   */
+  Map(const Map &other);
+
   /**
    * @brief Default destructor for the Map class.
    */
@@ -32,12 +63,23 @@ public:
    *
    * The map data is represented by a vector of strings. Each string represents a row in the map.
    * Different characters in the string represent different objects in the game.
-   * If the object is solid it false gets pushed to the grid otherwise true is pushed.
+   * The size of the map is taken from the data, all rows are expected to have the same length.
+   * If the object is solid its tile is marked as blocked in the grid otherwise it is marked as open.
+   * Maps of at least hierarchyMinSize tiles in either dimension also get a hierarchical graph for long paths.
    *
    * @param mapData A vector of strings representing the map data.
    */
   void load(const std::vector<std::string> &mapData);
 
+  /**
+   * @brief Creates a read-only copy of the map grid.
+   *
+   * The snapshot is safe to search from other threads while this map keeps being used on the main thread.
+   *
+   * @return std::shared_ptr<const Map> The read-only copy of the map.
+   */
+  std::shared_ptr<const Map> snapshot() const;
+
   /**
    * @brief Checks whether a given coordinate pair (x, y) is accessible in the map.
    *
@@ -49,17 +91,122 @@ public:
    */
   bool isAccessible(int x, int y) const;
 
+  /**
+   * @brief Checks whether a unit can walk in a straight line from one tile to another.
+   *
+   * The unit is a one tile square moving with its top-left corner along the line between the two tiles, every tile it
+   * overlaps on the way has to be open. Touching a blocked tile with an edge or a corner is allowed, cutting through it
+   * is not, which matches the corner rule of the searches for diagonal steps.
+   *
+   * @param fromX The x-coordinate of the first tile.
+   * @param fromY The y-coordinate of the first tile.
+   * @param toX The x-coordinate of the second tile.
+   * @param toY The y-coordinate of the second tile.
+   * @return bool True if every tile swept by the unit is open, false otherwise.
+   */
+  bool hasLineOfSight(int fromX, int fromY, int toX, int toY) const;
+
+  /**
+   * @brief Turns a tile path into the corners a unit walks between, skipping corners it can see past.
+   *
+   * The tiles are reduced to their corners first, then string pulling keeps a corner only if the previous kept corner
+   * has no line of sight to the one after it.
+   *
+   * @param tiles The path from a search, from the start tile to the goal tile.
+   * @param path Output buffer for the smoothed path, starting with the start tile and ending with the goal tile.
+   */
+  void smoothPath(const std::vector<std::pair<int, int>> &tiles, WaypointBuffer &path) const;
+
+  /**
+   * @brief Smooths a path that is already reduced to its corners, see the other overload.
+   *
+   * @param corners The corners of the path.
+   * @param path Output buffer for the smoothed path, must not be the input buffer.
+   */
+  void smoothPath(const WaypointBuffer &corners, WaypointBuffer &path) const;
+
   /**
    * @brief Calculates the path between two points using the A* algorithm.
    *
    * @param startCoords The coordinates (x, y) of the starting point.
    * @param targetCoords The coordinates (x, y) of the target point.
-   * @return std::list<std::pair<int, int>> A list of coordinates representing the calculated path.
+   * @param path Output buffer for the smoothed path, from the start tile to the target tile, empty if there is no path.
+   */
+  void calculatePath(std::pair<int, int> startCoords, std::pair<int, int> targetCoords, WaypointBuffer &path);
+
+  /**
+   * @brief Returns the flow field leading to a goal rectangle.
+   *
+   * Flow fields are computed once per destination and shared by every unit heading there. The most recently used
+   * fields are kept in a small cache keyed by the goal, so repeated destinations (castles, resources) are not
+   * recomputed. The cache is cleared when new map data is loaded.
+   *
+   * @param goalX The x-coordinate of the top-left tile of the goal.
+   * @param goalY The y-coordinate of the top-left tile of the goal.
+   * @param goalWidth The width of the goal in tiles.
+   * @param goalHeight The height of the goal in tiles.
+   * @return std::shared_ptr<const FlowField> The flow field leading to the goal.
+   */
+  std::shared_ptr<const FlowField> getFlowField(int goalX, int goalY, int goalWidth = 1, int goalHeight = 1);
+
+  /**
+   * @brief Returns the walkability grid of the map.
+   *
+   * Pathfinders read the grid directly to use its neighbourhood and row span queries.
+   *
+   * @return const BitGrid& The walkability grid.
+   */
+  const BitGrid &getGrid() const;
+
+  /**
+   * @brief Returns the hierarchical graph of the map.
+   *
+   * @return const HierarchicalMap* The hierarchical graph, or nullptr if the map is too small to need one.
+   */
+  const HierarchicalMap *getHierarchy() const;
+
+  /**
+   * @brief Sets the search algorithm used by calculatePath.
+   *
+   * @param mode The pathfinding mode to use for this map.
+   */
+  void setPathfindingMode(PathfindingMode mode);
+
+  /**
+   * @brief Returns the search algorithm used by calculatePath.
+   *
+   * @return PathfindingMode The pathfinding mode of this map.
+   */
+  PathfindingMode getPathfindingMode() const;
+
+  /**
+   * @brief Returns the width of the map grid in tiles.
+   *
+   * @return int The number of columns in the map grid.
+   */
+  int getWidth() const;
+
+  /**
+   * @brief Returns the height of the map grid in tiles.
+   *
+   * @return int The number of rows in the map grid.
    */
-  std::list<std::pair<int, int>> calculatePath(std::pair<int, int> startCoords, std::pair<int, int> targetCoords);
+  int getHeight() const;
 
 private:
-  std::vector<std::vector<bool>> grid;
+  BitGrid grid;
+  int width;
+  int height;
+
+  PathfindingMode pathfindingMode;
+  std::unique_ptr<AStar> pathFinder;
+  std::vector<std::pair<int, int>> pathBuffer;
+
+  std::shared_ptr<const HierarchicalMap> hierarchy;
+  static const int hierarchyMinSize = 128;
+
+  std::list<std::shared_ptr<const FlowField>> flowFields;
+  static const size_t flowFieldCacheSize = 16;
 };
 
 #endif
@@ -0,0 +1,152 @@
+#include "PathQueue.h"
+#include "AStar.h"
+#include "HierarchicalMap.h"
+#include <algorithm>
+
+PathQueue::PathQueue(std::shared_ptr<const Map> map, unsigned int threadCount) : map(std::move(map)), nextTicket(1), stopping(false)
+{
+  if (threadCount == 0)
+  {
+    // Leave one hardware thread for the main loop
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    threadCount = hardwareThreads > 1 ? std::min(4u, hardwareThreads - 1) : 1;
+  }
+
+  for (unsigned int i = 0; i < threadCount; ++i)
+  {
+    workers.emplace_back(&PathQueue::work, this);
+  }
+}
+
+PathQueue::~PathQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  requestAvailable.notify_all();
+
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+uint32_t PathQueue::request(UnitHandle unit, std::pair<int, int> startCoords, std::pair<int, int> targetCoords)
+{
+  uint32_t ticket;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ticket = nextTicket++;
+    if (nextTicket == 0)
+    {
+      nextTicket = 1;
+    }
+    activeTickets.insert(ticket);
+    requests.push_back({unit, ticket, startCoords, targetCoords});
+  }
+  requestAvailable.notify_one();
+  return ticket;
+}
+
+void PathQueue::cancel(uint32_t ticket)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Queued requests and finished results of the ticket are skipped once it is no longer active
+  activeTickets.erase(ticket);
+}
+
+size_t PathQueue::collect(std::vector<Result> &results, size_t budget)
+{
+  results.clear();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  while (!this->results.empty() && results.size() < budget)
+  {
+    Result result = std::move(this->results.front());
+    this->results.pop_front();
+
+    if (activeTickets.erase(result.ticket))
+    {
+      results.push_back(std::move(result));
+    }
+  }
+  return results.size();
+}
+
+void PathQueue::work()
+{
+  // Every worker owns its search buffers, the map snapshot is only read
+  AStar pathFinder(*map);
+  std::vector<std::pair<int, int>> pathBuffer;
+  std::vector<std::pair<int, int>> waypointBuffer;
+
+  while (true)
+  {
+    Request request;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      requestAvailable.wait(lock, [this]()
+                            { return stopping || !requests.empty(); });
+      if (stopping)
+        return;
+
+      request = requests.front();
+      requests.pop_front();
+
+      if (activeTickets.find(request.ticket) == activeTickets.end())
+        continue;
+    }
+
+    // On hierarchical maps only the way to the first abstract waypoint is searched, the rest is passed on
+    std::pair<int, int> segmentTarget = request.targetCoords;
+    size_t remainingWaypoints = 0;
+    const HierarchicalMap *hierarchy = map->getHierarchy();
+    if (hierarchy)
+    {
+      if (hierarchy->findAbstractPath(*map, request.startCoords, request.targetCoords, waypointBuffer))
+      {
+        segmentTarget = waypointBuffer[1];
+        remainingWaypoints = waypointBuffer.size() - 2;
+      }
+      else
+      {
+        segmentTarget = {-1, -1};
+      }
+    }
+
+    pathBuffer.clear();
+    if (segmentTarget.first >= 0)
+    {
+      if (map->getPathfindingMode() == JUMP_POINT)
+      {
+        pathFinder.findJumpPointPath(request.startCoords.first, request.startCoords.second, segmentTarget.first, segmentTarget.second, pathBuffer);
+      }
+      else if (map->getPathfindingMode() == THETA_STAR)
+      {
+        pathFinder.findThetaStarPath(request.startCoords.first, request.startCoords.second, segmentTarget.first, segmentTarget.second, pathBuffer);
+      }
+      else
+      {
+        pathFinder.findPath(request.startCoords.first, request.startCoords.second, segmentTarget.first, segmentTarget.second, pathBuffer);
+      }
+    }
+
+    Result result{request.unit, request.ticket, WaypointBuffer(), WaypointBuffer()};
+    map->smoothPath(pathBuffer, result.path);
+    if (!pathBuffer.empty())
+    {
+      for (size_t i = waypointBuffer.size() - remainingWaypoints; i < waypointBuffer.size(); ++i)
+      {
+        result.waypoints.pushBack(waypointBuffer[i]);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (activeTickets.find(request.ticket) != activeTickets.end())
+    {
+      results.push_back(std::move(result));
+    }
+  }
+}
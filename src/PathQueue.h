@@ -0,0 +1,113 @@
+#ifndef PATHQUEUE_H
+#define PATHQUEUE_H
+
+#include "Map.h"
+#include "UnitStore.h"
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <utility>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class PathQueue
+ * @brief Solves path requests asynchronously on worker threads.
+ *
+ * Units enqueue a request when they get a move order and wait until the result is collected on the main thread.
+ * Worker threads search on a read-only snapshot of the map grid, each with its own AStar buffers, so no search ever
+ * touches state shared with the main thread. On maps with a hierarchical graph the path is planned as abstract
+ * waypoints and only the way to the first of them is refined here, the unit refines the rest as it walks.
+ *
+ * Every request gets a ticket. Cancelling a ticket (unit died, new order) drops the request wherever it is, results
+ * of cancelled tickets are never handed out.
+ */
+class PathQueue
+{
+public:
+  /**
+   * @struct Result
+   * @brief A solved path request ready to be applied to its unit.
+   */
+  struct Result
+  {
+    UnitHandle unit;                          /**< The unit that made the request. */
+    uint32_t ticket;                          /**< The ticket of the request. */
+    WaypointBuffer path;      /**< The smoothed path in grid coordinates, empty if no path was found. */
+    WaypointBuffer waypoints; /**< Waypoints still to be refined after the path, on hierarchical maps. */
+  };
+
+  /**
+   * @brief Constructs the queue and starts its worker threads.
+   *
+   * @param map The read-only map snapshot the paths are searched on.
+   * @param threadCount The number of worker threads, 0 picks a count based on the available hardware threads.
+   */
+  PathQueue(std::shared_ptr<const Map> map, unsigned int threadCount = 0);
+
+  /**
+   * @brief Stops the worker threads and waits for them to finish.
+   */
+  ~PathQueue();
+
+  /**
+   * @brief Enqueues a path request.
+   *
+   * @param unit The handle of the unit the result belongs to.
+   * @param startCoords The coordinates (x, y) of the starting point.
+   * @param targetCoords The coordinates (x, y) of the target point.
+   * @return uint32_t The ticket of the request, never 0.
+   */
+  uint32_t request(UnitHandle unit, std::pair<int, int> startCoords, std::pair<int, int> targetCoords);
+
+  /**
+   * @brief Cancels a request, its result will never be collected.
+   *
+   * @param ticket The ticket of the request to cancel.
+   */
+  void cancel(uint32_t ticket);
+
+  /**
+   * @brief Moves finished results into a buffer.
+   *
+   * @param results Output buffer, cleared before the results are added.
+   * @param budget The maximum number of results to collect, the rest stays queued for the next call.
+   * @return size_t The number of collected results.
+   */
+  size_t collect(std::vector<Result> &results, size_t budget);
+
+private:
+  /**
+   * @struct Request
+   * @brief A path request waiting for a worker thread.
+   */
+  struct Request
+  {
+    UnitHandle unit;
+    uint32_t ticket;
+    std::pair<int, int> startCoords;
+    std::pair<int, int> targetCoords;
+  };
+
+  /**
+   * @brief Main loop of a worker thread, solves requests until the queue is stopped.
+   */
+  void work();
+
+  std::shared_ptr<const Map> map;
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable requestAvailable;
+  std::deque<Request> requests;
+  std::deque<Result> results;
+  std::unordered_set<uint32_t> activeTickets;
+  uint32_t nextTicket;
+  bool stopping;
+};
+
+#endif
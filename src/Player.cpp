@@ -1,12 +1,13 @@
 #include "Game.h"
 #include "Player.h"
+#include "FlowField.h"
 #include "utils.h"
 #include <cmath>
 #include <algorithm>
 #include <string>
 #include <functional>
 
-Player::Player(int x, int y, int id, bool &talentsVisible, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
+Player::Player(int x, int y, int id, bool &talentsVisible, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
     : allUnits(allUnits),
       speedMultiplier(1.0),
       healthMultiplier(1.0),
@@ -24,10 +25,20 @@ Player::Player(int x, int y, int id, bool &talentsVisible, std::vector<std::uniq
       spawnInterval(15000),
       id(id),
       castle(x, y, 48, 48, id, allUnits, unitsToRemove, allWalls, allResources, allCastles, speedMultiplier, healthMultiplier, spawnRateMultiplier, hasteMultiplier, baseAttackDamage, baseAttackSpeed, gatherRate, wood, crystals, spawnInterval),
+      pressedX(0),
+      pressedY(0),
       isControlling(false),
-      talentsVisible(talentsVisible)
+      talentsVisible(talentsVisible),
+      selectMenuVisible(false)
 {
 
+  // Without a window the player has no menus, the talent manager then works without buttons
+  if (Game::headless)
+  {
+    talentManager = std::make_unique<TalentManager>(crystals, wood, speedMultiplier, healthMultiplier, spawnRateMultiplier, hasteMultiplier, baseAttackDamage, nullptr);
+    return;
+  }
+
   selectMenu = std::make_unique<Menu>();
   talentsMenu = std::make_unique<Menu>();
   talentManager = std::make_unique<TalentManager>(crystals, wood, speedMultiplier, healthMultiplier, spawnRateMultiplier, hasteMultiplier, baseAttackDamage, talentsMenu.get());
@@ -46,13 +57,8 @@ Player::Player(int x, int y, int id, bool &talentsVisible, std::vector<std::uniq
 
   std::function<void()> deselectAll = [this]()
   {
-    for (auto *unit : selectedUnits)
-    {
-      unit->setTexture(unit->getType() == "soldier" ? getSoldierTexturePath(unit->getOwnerId()).first : getWorkerTexturePath(unit->getOwnerId()).first);
-    }
-    selectedUnits.clear();
+    commands.push(PlayerCommand{PlayerCommand::DESELECT_ALL, 0, 0, 0, 0});
     Game::resetCursor();
-    isControlling = false;
   };
 
   selectMenu->addImageButton(windowWidth - 20 - 50 - 50, 19, 50, 50, "./assets/deselect.png", "./assets/deselect_hovered.png", deselectAll);
@@ -60,10 +66,59 @@ Player::Player(int x, int y, int id, bool &talentsVisible, std::vector<std::uniq
 
 Player::~Player() = default;
 
-void Player::update()
+void Player::applyCommands()
+{
+  commands.drain(commandsOfTick);
+  for (const PlayerCommand &command : commandsOfTick)
+  {
+    switch (command.type)
+    {
+    case PlayerCommand::CLICK_AREA:
+      startX = command.startX;
+      startY = command.startY;
+      endX = command.endX;
+      endY = command.endY;
+
+      if (isControlling)
+      {
+        setUnitsTarget(endX, endY);
+        isControlling = false;
+      }
+      else
+      {
+        selectUnits();
+        if (!selectedUnits.empty())
+          isControlling = true;
+      }
+      break;
+    case PlayerCommand::DESELECT_ALL:
+      deselectAll();
+      break;
+    }
+  }
+}
+
+void Player::deselectAll()
+{
+  for (UnitHandle handle : selectedUnits)
+  {
+    Unit *unit = LevelScene::getUnitStore().get(handle);
+    if (unit == nullptr)
+      continue;
+    unit->setTexture(getUnitTexturePath(unit->getType(), unit->getOwnerId()).first);
+  }
+  selectedUnits.clear();
+  isControlling = false;
+}
+
+void Player::updateInterface(const RenderSnapshot &snapshot)
 {
+  if (Game::headless)
+    return;
 
-  if (isControlling && !talentsVisible)
+  selectMenuVisible = snapshot.controlling;
+
+  if (selectMenuVisible && !talentsVisible)
   {
     selectMenu->update();
   }
@@ -73,21 +128,23 @@ void Player::update()
     talentsMenu->update();
   }
 
-  if (woodText != nullptr && wood != lastWood)
+  if (woodText != nullptr && snapshot.wood != lastWood)
   {
-    lastWood = wood;
-    woodText->setText("planks :  " + std::to_string(wood));
+    lastWood = snapshot.wood;
+    woodText->setText("planks :  " + std::to_string(lastWood));
   }
 
-  if (crystalsText != nullptr && crystals != lastCrystals)
+  if (crystalsText != nullptr && snapshot.crystals != lastCrystals)
   {
-    lastCrystals = crystals;
-    crystalsText->setText("crystals :  " + std::to_string(crystals));
+    lastCrystals = snapshot.crystals;
+    crystalsText->setText("crystals :  " + std::to_string(lastCrystals));
   }
 }
 void Player::render()
 {
-  if (isControlling)
+  if (Game::headless)
+    return;
+  if (selectMenuVisible)
   {
     selectMenu->render();
   }
@@ -110,8 +167,8 @@ void Player::handleInput(const SDL_Event &event)
 
       if (mouseY >= 88 && !talentsVisible)
       {
-        startX = mouseX;
-        startY = mouseY;
+        pressedX = mouseX;
+        pressedY = mouseY;
       }
     }
     break;
@@ -125,27 +182,15 @@ void Player::handleInput(const SDL_Event &event)
       {
         talentsMenu->handleClick(mouseX, mouseY);
       }
-      if (isControlling && !talentsVisible)
+      if (selectMenuVisible && !talentsVisible)
       {
         selectMenu->handleClick(mouseX, mouseY);
       }
 
+      // Whether the click selects or gives an order is decided by the simulation, it knows the current selection
       if (mouseY >= 88 && !talentsVisible)
       {
-        endX = mouseX;
-        endY = mouseY;
-
-        if (isControlling)
-        {
-          setUnitsTarget(endX, endY);
-          isControlling = false;
-        }
-        else
-        {
-          selectUnits();
-          if (!selectedUnits.empty())
-            isControlling = true;
-        }
+        commands.push(PlayerCommand{PlayerCommand::CLICK_AREA, pressedX, pressedY, mouseX, mouseY});
       }
     }
     break;
@@ -170,24 +215,38 @@ void Player::selectUnits()
         unit->getActualX() >= leftX && (unit->getActualX() + unitWidth) <= rightX &&
         unit->getActualY() >= topY && (unit->getActualY() + unitHeight) <= bottomY)
     {
-      unit->setTexture(unit->getType() == "soldier" ? getSoldierTexturePath(unit->getOwnerId()).second : getWorkerTexturePath(unit->getOwnerId()).second);
-      selectedUnits.push_back(unit.get());
+      unit->setTexture(getUnitTexturePath(unit->getType(), unit->getOwnerId()).second);
+      selectedUnits.push_back(unit->getHandle());
     }
   }
 }
 
 void Player::setUnitsTarget(int targetX, int targetY)
 {
-  for (auto *unit : selectedUnits)
+  // A group heading to the same tile shares one flow field instead of running a search per unit
+  std::shared_ptr<const FlowField> flowField;
+  if (selectedUnits.size() > 1)
   {
-    unit->moveTo(targetX, targetY);
-    unit->setTexture(unit->getType() == "soldier" ? getSoldierTexturePath(unit->getOwnerId()).first : getWorkerTexturePath(unit->getOwnerId()).first);
+    flowField = LevelScene::getMap().getFlowField(targetX / 16, (targetY - 88) / 16);
+  }
+
+  for (UnitHandle handle : selectedUnits)
+  {
+    Unit *unit = LevelScene::getUnitStore().get(handle);
+    if (unit == nullptr)
+      continue;
+
+    if (flowField)
+      unit->followFlowField(*flowField);
+    else
+      unit->moveTo(targetX, targetY);
+    unit->setTexture(getUnitTexturePath(unit->getType(), unit->getOwnerId()).first);
   }
 
   selectedUnits.clear();
 }
 
-std::vector<Unit *> &Player::getSelectedUnits()
+std::vector<UnitHandle> &Player::getSelectedUnits()
 {
   return selectedUnits;
 }
@@ -197,7 +256,7 @@ Castle &Player::getCastle()
   return castle;
 }
 
-void Player::addUnit(int x, int y, const std::string &type, int health)
+void Player::addUnit(int x, int y, UnitType type, int health)
 {
   castle.spawnUnit(x, y, type, health);
 }
@@ -7,6 +7,8 @@
 #include "Menu.h"
 #include "Text.h"
 #include "TalentManager.h"
+#include "CommandQueue.h"
+#include "RenderSnapshot.h"
 #include <vector>
 #include <memory>
 
@@ -15,7 +17,8 @@
  * @brief Represents a player in the game.
  *
  * The Player class manages the state and actions of a player in the game. It controls units, resources, menus, and talents.
- * It handles user input, updates the player's state, and renders the player's menus and objects.
+ * It handles user input, updates the player's state, and renders the player's menus and objects. Input and menus
+ * belong to the render thread, orders for the units are queued as commands for the simulation thread.
  */
 class Player
 {
@@ -35,7 +38,7 @@ public:
    * @param allResources A reference to the vector containing all resources.
    * @param allCastles A reference to the vector containing all castles.
    */
-  Player(int x, int y, int id, bool &talentsVisible, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
+  Player(int x, int y, int id, bool &talentsVisible, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
 
   /**
    * @brief Default destructor for the Player class.
@@ -43,11 +46,19 @@ public:
   ~Player();
 
   /**
-   * @brief Update the state of the player.
+   * @brief Carries out the commands given since the last tick, called by the simulation at the start of a tick.
+   */
+  void applyCommands();
+
+  /**
+   * @brief Updates the menus of the player on the render thread.
+   *
+   * This includes updating the select and talent menus, as well as updating the wood and crystal texts in the menu
+   * from the newest snapshot of the simulation.
    *
-   * This includes updating the select and talent menus, as well as updating the wood and crystal texts in the menu.
+   * @param snapshot The newest render snapshot of the level.
    */
-  void update();
+  void updateInterface(const RenderSnapshot &snapshot);
 
   /**
    * @brief Renders the player's menus.
@@ -57,7 +68,7 @@ public:
   /**
    * @brief Handles the user input for the player.
    *
-   * This includes clicking on menus and selecting units.
+   * This includes clicking on menus and selecting units. Selecting units and giving them orders is queued as a command.
    *
    * @param event A SDL_Event object containing the details of the event.
    */
@@ -68,6 +79,18 @@ public:
    */
   void selectUnits();
 
+  /**
+   * @brief Drops the selection and gives the selected units their normal texture back.
+   */
+  void deselectAll();
+
+  /**
+   * @brief Checks whether the player has units selected, so the next click gives them a target.
+   *
+   * @return True if units are selected; otherwise, false.
+   */
+  bool isControllingUnits() const { return isControlling; };
+
   /**
    * @brief Sets the target coords for the selected units.
    *
@@ -84,7 +107,7 @@ public:
    * @param type The type of the unit.
    * @param health The health of the unit.
    */
-  void addUnit(int x, int y, const std::string &type, int health);
+  void addUnit(int x, int y, UnitType type, int health);
 
   /**
    * @brief Adds crystals to the player's resources.
@@ -124,9 +147,9 @@ public:
   /**
    * @brief Returns a vector containing the currently selected units.
    *
-   * @return A vector of pointers to the selected units.
+   * @return A vector of handles to the selected units, handles of units that died may be stale.
    */
-  std::vector<Unit *> &getSelectedUnits();
+  std::vector<UnitHandle> &getSelectedUnits();
 
   /**
    * @brief Returns a reference to the player's castle.
@@ -150,7 +173,7 @@ public:
   int getId() const;
 
 private:
-  std::vector<Unit *> selectedUnits;
+  std::vector<UnitHandle> selectedUnits;
   std::vector<std::unique_ptr<Unit>> &allUnits;
   std::unique_ptr<Menu> talentsMenu;
   std::unique_ptr<Menu> selectMenu;
@@ -183,8 +206,16 @@ private:
   int endX;
   int endY;
 
+  // Where the mouse was pressed, only used by the render thread
+  int pressedX;
+  int pressedY;
+
   bool isControlling;
   bool &talentsVisible;
+
+  CommandQueue commands;
+  std::vector<PlayerCommand> commandsOfTick;
+  bool selectMenuVisible;
 };
 
 #endif
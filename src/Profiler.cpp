@@ -0,0 +1,133 @@
+#include "Profiler.h"
+
+#ifdef ENABLE_PROFILING
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+  /**
+   * @brief A finished zone.
+   */
+  struct ZoneRecord
+  {
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  /**
+   * @brief The ring buffer of one thread.
+   *
+   * Only its thread writes into it, the mutex is taken uncontended except while a trace is written.
+   */
+  struct ThreadBuffer
+  {
+    static const size_t capacity = 1 << 16;
+
+    explicit ThreadBuffer(int threadId) : threadId(threadId), records(capacity), next(0), count(0) {}
+
+    int threadId;
+    std::vector<ZoneRecord> records;
+    size_t next;
+    size_t count;
+    std::mutex mutex;
+  };
+
+  std::mutex buffersMutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+  /**
+   * @brief Returns the ring buffer of the current thread, registering it on first use.
+   *
+   * The buffers are shared with the registry, the zones of a finished thread stay available for the trace.
+   */
+  ThreadBuffer &threadBuffer()
+  {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []()
+    {
+      std::lock_guard<std::mutex> lock(buffersMutex);
+      buffers.push_back(std::make_shared<ThreadBuffer>(static_cast<int>(buffers.size()) + 1));
+      return buffers.back();
+    }();
+    return *buffer;
+  }
+
+  /**
+   * @brief Writes a string as a JSON string literal, zone names are identifiers but may contain colons.
+   */
+  void writeJsonString(std::ofstream &file, const char *text)
+  {
+    file << '"';
+    for (const char *c = text; *c; ++c)
+    {
+      if (*c == '"' || *c == '\\')
+        file << '\\';
+      file << *c;
+    }
+    file << '"';
+  }
+}
+
+Profiler::Zone::Zone(const char *name) : name(name), start(Profiler::now()) {}
+
+Profiler::Zone::~Zone()
+{
+  Profiler::record(name, start, Profiler::now());
+}
+
+uint64_t Profiler::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end)
+{
+  ThreadBuffer &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.records[buffer.next] = {name, start, end};
+  buffer.next = (buffer.next + 1) % ThreadBuffer::capacity;
+  if (buffer.count < ThreadBuffer::capacity)
+    buffer.count++;
+}
+
+bool Profiler::writeTrace(const std::string &filePath)
+{
+  std::ofstream file(filePath);
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> registryLock(buffersMutex);
+
+  // Complete events ("ph": "X") with microsecond timestamps, nested zones are stacked by the viewer
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+  for (const auto &buffer : buffers)
+  {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    size_t oldest = (buffer->next + ThreadBuffer::capacity - buffer->count) % ThreadBuffer::capacity;
+    for (size_t i = 0; i < buffer->count; ++i)
+    {
+      const ZoneRecord &record = buffer->records[(oldest + i) % ThreadBuffer::capacity];
+      file << (first ? "\n" : ",\n") << "{\"name\": ";
+      writeJsonString(file, record.name);
+      file << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+           << ", \"ts\": " << record.start / 1000.0 << ", \"dur\": " << (record.end - record.start) / 1000.0 << "}";
+      first = false;
+    }
+  }
+  file << "\n]}\n";
+  return file.good();
+}
+
+#endif
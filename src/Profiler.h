@@ -0,0 +1,105 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/**
+ * @file Profiler.h
+ * @brief Scoped profiling zones, exported as a Chrome trace.
+ *
+ * A zone measures the time from its construction to the end of its scope:
+ *
+ *     void Game::update()
+ *     {
+ *       PROFILE_SCOPE("Game::update");
+ *       ...
+ *     }
+ *
+ * The zones are only recorded when the game is built with ENABLE_PROFILING defined (`make PROFILING=1`). Otherwise
+ * PROFILE_SCOPE expands to nothing and the Profiler class doesn't exist, so instrumented code costs nothing.
+ *
+ * Every thread records into its own ring buffer, the oldest zones are overwritten once it is full. Profiler::writeTrace
+ * saves the buffers in the Chrome trace event format, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+ */
+
+#ifdef ENABLE_PROFILING
+
+#include <cstdint>
+#include <string>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Records a zone named name from this line to the end of the enclosing scope.
+ *
+ * @param name The name of the zone, a string literal.
+ */
+#define PROFILE_SCOPE(name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+/**
+ * @class Profiler
+ * @brief Collects the profiling zones of all threads.
+ */
+class Profiler
+{
+public:
+  /**
+   * @class Zone
+   * @brief Measures the lifetime of a scope and records it when the scope ends.
+   */
+  class Zone
+  {
+  public:
+    /**
+     * @brief Starts the zone.
+     *
+     * @param name The name of the zone, must outlive the profiler, so a string literal.
+     */
+    explicit Zone(const char *name);
+
+    /**
+     * @brief Ends the zone and records it into the ring buffer of the current thread.
+     */
+    ~Zone();
+
+    Zone(const Zone &) = delete;
+    Zone &operator=(const Zone &) = delete;
+
+  private:
+    const char *name;
+    uint64_t start;
+  };
+
+  /**
+   * @brief Returns the time since the profiler started.
+   *
+   * @return uint64_t The time in nanoseconds.
+   */
+  static uint64_t now();
+
+  /**
+   * @brief Records a finished zone into the ring buffer of the current thread.
+   *
+   * @param name The name of the zone.
+   * @param start The start of the zone in nanoseconds, see now.
+   * @param end The end of the zone in nanoseconds, see now.
+   */
+  static void record(const char *name, uint64_t start, uint64_t end);
+
+  /**
+   * @brief Writes the recorded zones of all threads as a Chrome trace.
+   *
+   * The buffers are not cleared, a later trace contains the zones still in the buffers.
+   *
+   * @param filePath The path of the JSON file to write.
+   * @return bool True if the file was written, false otherwise.
+   */
+  static bool writeTrace(const std::string &filePath);
+};
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+#include "RenderSnapshot.h"
+#include "SpriteBatch.h"
+#include <cmath>
+
+void RenderSnapshot::clear()
+{
+  castles.clear();
+  units.clear();
+}
+
+void RenderSnapshot::draw(SpriteBatch &batch, float interpolation) const
+{
+  for (const Sprite &castle : castles)
+  {
+    drawSprite(batch, castle, interpolation);
+  }
+
+  for (const Sprite &unit : units)
+  {
+    drawSprite(batch, unit, interpolation);
+  }
+}
+
+void RenderSnapshot::drawSprite(SpriteBatch &batch, const Sprite &sprite, float interpolation)
+{
+  // Draw the sprite part of the way from its previous position, the simulation runs ahead of rendering
+  SDL_Rect renderRect = sprite.rect;
+  renderRect.x = sprite.previous.x + (int)std::round((sprite.rect.x - sprite.previous.x) * interpolation);
+  renderRect.y = sprite.previous.y + (int)std::round((sprite.rect.y - sprite.previous.y) * interpolation);
+
+  if (sprite.region)
+  {
+    batch.addSprite(*sprite.region, renderRect);
+  }
+  else if (sprite.texture)
+  {
+    batch.addTexture(sprite.texture, renderRect);
+  }
+
+  // Create a rectangle for the total health (red)
+  SDL_Rect healthBarRect;
+  healthBarRect.x = renderRect.x;
+  healthBarRect.y = renderRect.y - 6; // Position it 6px above the sprite
+  healthBarRect.w = sprite.healthBarWidth;
+  healthBarRect.h = 4;
+
+  // Render the total health bar (red)
+  batch.addRect(healthBarRect, SDL_Color{255, 0, 0, 255});
+
+  // The current health (green) scaled to the bar, nothing is left of it once the health is gone
+  SDL_Rect currentHealthRect = healthBarRect;
+  currentHealthRect.w = (int)((float)sprite.health / sprite.maxHealth * sprite.healthBarWidth);
+
+  batch.addRect(currentHealthRect, SDL_Color{0, 255, 0, 255});
+}
@@ -0,0 +1,70 @@
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+
+class SpriteBatch;
+
+/**
+ * @class RenderSnapshot
+ * @brief Everything needed to draw the changing part of a level, copied out of the simulation at the end of a tick.
+ *
+ * The simulation thread fills a snapshot and publishes it, the render thread draws from it while the next tick runs.
+ * Nothing in it points into the simulation, the sprite regions and textures belong to the resource manager.
+ */
+class RenderSnapshot
+{
+public:
+  /**
+   * @struct Sprite
+   * @brief A castle or unit with its health bar.
+   */
+  struct Sprite
+  {
+    SDL_Point previous;     /**< Position at the start of the tick. */
+    SDL_Rect rect;          /**< Position at the end of the tick and size. */
+    const SDL_Rect *region; /**< Region in the texture atlas, nullptr if the texture is drawn on its own. */
+    SDL_Texture *texture;   /**< Texture used when the sprite is not in the atlas. */
+    int health;
+    int maxHealth;
+    int healthBarWidth;
+  };
+
+  /**
+   * @brief Forgets the sprites of an earlier tick, keeping the memory of the lists.
+   */
+  void clear();
+
+  /**
+   * @brief Draws the castles and then the units into a batch.
+   *
+   * @param batch The batch of the game area.
+   * @param interpolation The fraction of a tick passed since the snapshot was published, units are drawn that far
+   * from their previous to their current position.
+   */
+  void draw(SpriteBatch &batch, float interpolation) const;
+
+  std::vector<Sprite> castles;
+  std::vector<Sprite> units;
+  int wood = 0;
+  int crystals = 0;
+  bool controlling = false;  /**< True if the player has units selected and the next click gives them a target. */
+  bool gameOver = false;
+  bool playerWon = false;
+  uint32_t tick = 0;         /**< The tick the snapshot was taken after. */
+  uint64_t publishedAt = 0;  /**< Performance counter when the snapshot was published. */
+
+private:
+  /**
+   * @brief Draws one sprite and its health bar.
+   *
+   * @param batch The batch of the game area.
+   * @param sprite The sprite to draw.
+   * @param interpolation The fraction of the way from the previous to the current position.
+   */
+  static void drawSprite(SpriteBatch &batch, const Sprite &sprite, float interpolation);
+};
+
+#endif
@@ -2,7 +2,7 @@
 #define RESOURCE_H
 
 #include "GameObject.h"
-#include <string>
+#include "UnitTypes.h"
 
 /**
  * @class Resource
@@ -23,9 +23,9 @@ public:
    * @param y The y-coordinate of the resource.
    * @param width The width of the resource.
    * @param height The height of the resource.
-   * @param type The type of the resource, can be "crystals" or "wood".
+   * @param type The type of the resource.
    */
-  Resource(int x, int y, int width, int height, std::string type);
+  Resource(int x, int y, int width, int height, ResourceType type);
 
   /**
    * @brief Default destructor for the Resource class.
@@ -35,19 +35,19 @@ public:
   /**
    * @brief Returns the type of the resource.
    *
-   * @return The type of the resource as a string.
+   * @return The type of the resource.
    */
-  std::string getType() const;
+  ResourceType getType() const;
 
   /**
    * @brief Sets the type of the resource.
    *
-   * @param newType The new type for the resource, can be "crystals" or "wood".
+   * @param newType The new type for the resource.
    */
-  void setType(std::string newType);
+  void setType(ResourceType newType);
 
 private:
-  std::string type;
+  ResourceType type;
 };
 
 #endif
\ No newline at end of file
@@ -5,11 +5,14 @@
 void ResourceManager::freeAllResources()
 {
   // Free textures
+  std::lock_guard<std::mutex> lock(textureMutex);
   for (auto &texturePair : textureMap)
   {
     SDL_DestroyTexture(texturePair.second);
   }
   textureMap.clear();
+  atlas.free();
+  glyphAtlases.clear();
 
   // Free fonts
   for (auto &fontPair : fonts)
@@ -21,12 +24,19 @@ void ResourceManager::freeAllResources()
 
 SDL_Texture *ResourceManager::loadTexture(const std::string &path)
 {
+  std::lock_guard<std::mutex> lock(textureMutex);
   auto it = textureMap.find(path);
   if (it != textureMap.end())
   {
     return it->second;
   }
 
+  // Without a renderer there is nothing to upload to, objects keep a null texture and are simply not drawn
+  if (Game::headless)
+  {
+    return nullptr;
+  }
+
   SDL_Texture *texture = IMG_LoadTexture(Game::renderer, path.c_str());
   if (texture == nullptr)
   {
@@ -40,6 +50,7 @@ SDL_Texture *ResourceManager::loadTexture(const std::string &path)
 
 void ResourceManager::freeTexture(const std::string &path)
 {
+  std::lock_guard<std::mutex> lock(textureMutex);
   auto it = textureMap.find(path);
   if (it != textureMap.end())
   {
@@ -51,6 +62,11 @@ void ResourceManager::freeTexture(const std::string &path)
 TTF_Font *ResourceManager::loadFont(const std::string &fontPath, int fontSize)
 {
   std::string key = fontPath + "_" + std::to_string(fontSize);
+  if (Game::headless)
+  {
+    return nullptr;
+  }
+
   if (fonts.count(key) == 0)
   {
     TTF_Font *font = TTF_OpenFont(fontPath.c_str(), fontSize);
@@ -71,4 +87,42 @@ void ResourceManager::freeFont(const std::string &fontPath, int fontSize)
     TTF_CloseFont(fonts[key]);
     fonts.erase(key);
   }
-}
\ No newline at end of file
+}
+
+const GlyphAtlas *ResourceManager::loadGlyphAtlas(const std::string &fontPath, int fontSize)
+{
+  std::string key = fontPath + "_" + std::to_string(fontSize);
+  auto it = glyphAtlases.find(key);
+  if (it != glyphAtlases.end())
+  {
+    return it->second.get();
+  }
+
+  TTF_Font *font = loadFont(fontPath, fontSize);
+  if (font == nullptr)
+  {
+    return nullptr;
+  }
+
+  auto glyphAtlas = std::make_unique<GlyphAtlas>();
+  if (!glyphAtlas->build(Game::renderer, font))
+  {
+    return nullptr;
+  }
+
+  return (glyphAtlases[key] = std::move(glyphAtlas)).get();
+}
+
+void ResourceManager::buildAtlas(const std::vector<std::string> &paths)
+{
+  if (Game::headless)
+    return;
+
+  atlas.build(Game::renderer, paths);
+
+  for (const auto &path : paths)
+  {
+    if (atlas.find(path) == nullptr)
+      loadTexture(path);
+  }
+}
@@ -4,8 +4,13 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
+#include "TextureAtlas.h"
+#include "GlyphAtlas.h"
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 /**
  * @class ResourceManager
@@ -28,9 +33,10 @@ public:
    * @brief Load a texture from a file into the manager.
    *
    * If the texture is already loaded, it will return the existing texture. If not, it will load it from file.
+   * Looking up a loaded texture is safe from any thread, loading one has to happen on the render thread.
    *
    * @param path Path to the texture file.
-   * @return Pointer to the loaded SDL_Texture. nullptr if loading failed.
+   * @return Pointer to the loaded SDL_Texture. nullptr if loading failed or the game runs headless.
    */
   SDL_Texture *loadTexture(const std::string &path);
 
@@ -50,7 +56,7 @@ public:
    *
    * @param fontPath Path to the font file.
    * @param fontSize The size of the font to be loaded.
-   * @return Pointer to the loaded TTF_Font. nullptr if loading failed.
+   * @return Pointer to the loaded TTF_Font. nullptr if loading failed or the game runs headless.
    */
   TTF_Font *loadFont(const std::string &fontPath, int fontSize);
 
@@ -64,8 +70,41 @@ public:
    */
   void freeFont(const std::string &fontPath, int fontSize);
 
+  /**
+   * @brief Load the glyph atlas of a font into the manager.
+   *
+   * If the glyphs of the font at the specific size are already rasterized, it will return the existing atlas. If not,
+   * it will load the font and build the atlas. The font stays loaded for the atlases of other texts.
+   *
+   * @param fontPath Path to the font file.
+   * @param fontSize The size of the font.
+   * @return Pointer to the glyph atlas. nullptr if the font could not be loaded or the game runs headless.
+   */
+  const GlyphAtlas *loadGlyphAtlas(const std::string &fontPath, int fontSize);
+
+  /**
+   * @brief Packs sprites into the texture atlas of the game.
+   *
+   * Objects whose texture is in the atlas are drawn in one batch with the others. Sprites that could not be packed
+   * are loaded as textures of their own right away, so objects of the level never load a texture later. Does nothing
+   * when the game runs headless.
+   *
+   * @param paths Paths of the sprite images.
+   */
+  void buildAtlas(const std::vector<std::string> &paths);
+
+  /**
+   * @brief Returns the texture atlas of the game.
+   *
+   * @return const TextureAtlas& The atlas, empty until buildAtlas is called.
+   */
+  const TextureAtlas &getAtlas() const { return atlas; }
+
 private:
   std::map<std::string, SDL_Texture *> textureMap;
+  std::mutex textureMutex;
+  TextureAtlas atlas;
   std::map<std::string, TTF_Font *> fonts;
+  std::map<std::string, std::unique_ptr<GlyphAtlas>> glyphAtlases;
 };
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Save.h"
 #include "Game.h"
+#include "Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -97,7 +98,12 @@ void Save::load()
         unit.health = std::stoi(value);
 
         // type
-        std::getline(iss, unit.type, ',');
+        std::getline(iss, value, ',');
+        if (!parseUnitType(value, unit.type))
+        {
+          printf("Unknown unit type in save file: %s\n", value.c_str());
+          continue;
+        }
 
         // coords.first
         std::getline(iss, value, ',');
@@ -183,6 +189,7 @@ void Save::load()
 
 void Save::save()
 {
+  PROFILE_SCOPE("Save::save");
   std::ofstream file(filePath, std::ofstream::trunc);
   if (!file.is_open())
   {
@@ -197,7 +204,7 @@ void Save::save()
 
     for (const auto &unit : level.units)
     {
-      file << "Unit," << unit.ownerId << "," << unit.health << "," << unit.type << "," << unit.coords.first << "," << unit.coords.second << "\n";
+      file << "Unit," << unit.ownerId << "," << unit.health << "," << getUnitStats(unit.type).name << "," << unit.coords.first << "," << unit.coords.second << "\n";
     }
 
     for (const auto &castle : level.castles)
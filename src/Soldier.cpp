@@ -1,71 +1,72 @@
 #include "Soldier.h"
+#include "LevelScene.h"
 #include "utils.h"
 #include <cmath>
 #include <algorithm>
 
-Soldier::Soldier(int x, int y, int width, int height, std::string type, int health, float speed, int baseAttackDamage, uint32_t attackSpeed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
-    : Unit(x, y, width, height, type, health, speed, ownerId, radius, allUnits, unitsToRemove, allWalls, allResources, allCastles), baseAttackDamage(baseAttackDamage), attackSpeed(attackSpeed) {}
+Soldier::Soldier(int x, int y, int width, int height, UnitType type, int health, float speed, int baseAttackDamage, uint32_t attackSpeed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
+    : Unit(x, y, width, height, type, health, speed, ownerId, radius, allUnits, unitsToRemove, allWalls, allResources, allCastles), baseAttackDamage(baseAttackDamage)
+{
+  setInteractionInterval(attackSpeed);
+}
 
 Soldier::~Soldier() = default;
 
-void Soldier::update()
+bool Soldier::planInteraction(uint64_t &random, UnitIntent &intent) const
 {
-  nextStep();
-  handleCollisions();
-
-  if (force.first != 0.0f || force.second != 0.0f)
-  {
-    applyForce();
-  }
+  intent.slot = slot;
+  intent.amount = randomInt(random, std::max(1, baseAttackDamage - 2), baseAttackDamage + 2);
 
-  uint32_t now = SDL_GetTicks();
-  uint32_t timeSinceLastInteraction = now - lastInteraction;
+  // Find a target among the units around
+  thread_local std::vector<int> nearbyUnits;
+  const SDL_Rect &rect = getRect();
+  int ownerId = getOwnerId();
+  int reach = getRadius() * 16 + 8;
+  SDL_Rect area = {rect.x + rect.w / 2 - reach, rect.y + rect.h / 2 - reach, 2 * reach, 2 * reach};
+  LevelScene::getUnitGrid().query(area, nearbyUnits);
 
-  if (timeSinceLastInteraction >= attackSpeed)
+  for (int index : nearbyUnits)
   {
-    // Reset the timer
-    lastInteraction = now;
-
-    bool didAttack = false;
+    if (index >= static_cast<int>(store.size()) || store.owners[index] == ownerId)
+      continue;
 
-    // Find a target and attack
-    for (const auto &potentialTarget : allUnits)
+    if (isInRange(*store.units[index]))
     {
-      if (potentialTarget->getOwnerId() != ownerId && isInRange(*potentialTarget))
-      {
-        attack(*potentialTarget);
-        didAttack = true;
-        break; // exit the loop once we've attacked
-      }
+      intent.kind = UnitIntent::ATTACK_UNIT;
+      intent.target = index;
+      return true;
     }
+  }
 
-    // If no units were in range, check for castles
-    for (const auto &potentialTarget : allCastles)
+  // If no units were in range, check for castles
+  for (size_t index = 0; index < allCastles.size(); ++index)
+  {
+    if (allCastles[index]->getOwnerId() != ownerId && isInRange(*allCastles[index]))
     {
-      if (didAttack)
-        break;
-      if (potentialTarget->getOwnerId() != ownerId && isInRange(*potentialTarget))
-      {
-        attack(*potentialTarget);
-        break; // exit the loop once we've attacked
-      }
+      intent.kind = UnitIntent::ATTACK_CASTLE;
+      intent.target = index;
+      return true;
     }
   }
+  return false;
 }
 
-Soldier *Soldier::clone() const
+void Soldier::applyInteraction(const UnitIntent &intent)
 {
-  return new Soldier(*this);
+  if (intent.kind == UnitIntent::ATTACK_UNIT)
+    attack(*store.units[intent.target], intent.amount);
+  else
+    attack(*allCastles[intent.target], intent.amount);
 }
 
-void Soldier::attack(Unit &target)
+void Soldier::attack(Unit &target, int damage)
 {
-  target.takeDamage(randomInt(std::max(1, baseAttackDamage - 2), baseAttackDamage + 2));
+  target.takeDamage(damage);
 }
 
-void Soldier::attack(Castle &target)
+void Soldier::attack(Castle &target, int damage)
 {
-  target.takeDamage(randomInt(std::max(1, baseAttackDamage - 2), baseAttackDamage + 2), getPosition());
+  target.takeDamage(damage, getPosition());
 }
 
 void Soldier::setAttackDamage(int damage)
@@ -37,7 +37,7 @@ public:
    * @param allResources Reference to all resources in the game.
    * @param allCastles Reference to all castles in the game.
    */
-  Soldier(int x, int y, int width, int height, std::string type, int health, float speed, int baseAttackDamage, uint32_t attackSpeed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
+  Soldier(int x, int y, int width, int height, UnitType type, int health, float speed, int baseAttackDamage, uint32_t attackSpeed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
 
   /**
    * @brief Destroy the Soldier object.
@@ -45,36 +45,39 @@ public:
   ~Soldier();
 
   /**
-   * @brief Update the soldier state, includes moving, handling collisions and attacking targets.
+   * @brief Picks a target in range, called once per attack interval.
    *
    * The soldier will try to attack units first. If no units are in range, it will attack castles in range.
+   * The damage is random within a range around the soldier's base attack damage.
+   *
+   * @param random The random stream of the soldier for this tick.
+   * @param intent Set to the attack.
+   * @return true if a target is in range, false otherwise.
    */
-  void update() override;
+  bool planInteraction(uint64_t &random, UnitIntent &intent) const override;
 
   /**
-   * @brief Creates a new Soldier object that is an exact copy of this Soldier.
+   * @brief Attacks the target picked by planInteraction.
    *
-   * @return Pointer to the cloned Soldier object.
+   * @param intent The attack.
    */
-  Soldier *clone() const override;
+  void applyInteraction(const UnitIntent &intent) override;
 
   /**
    * @brief Make the soldier attack a unit.
    *
-   * The damage inflicted on the unit is random within a range around the soldier's base attack damage.
-   *
    * @param target Reference to the unit being attacked.
+   * @param damage The damage inflicted on the unit.
    */
-  void attack(Unit &target);
+  void attack(Unit &target, int damage);
 
   /**
    * @brief Make the soldier attack a castle.
    *
-   * The damage inflicted on the castle is random within a range around the soldier's base attack damage.
-   *
    * @param target Reference to the castle being attacked.
+   * @param damage The damage inflicted on the castle.
    */
-  void attack(Castle &target);
+  void attack(Castle &target, int damage);
 
   /**
    * @brief Set the base attack damage of the soldier.
@@ -92,7 +95,6 @@ public:
 
 private:
   int baseAttackDamage;
-  uint32_t attackSpeed;
 };
 
 #endif
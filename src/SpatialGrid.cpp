@@ -0,0 +1,86 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(int cellSize) : cellSize(cellSize), originX(0), originY(0), columns(1), rows(1)
+{
+  cellStart.assign(2, 0);
+}
+
+void SpatialGrid::setArea(int x, int y, int width, int height)
+{
+  originX = x;
+  originY = y;
+  columns = std::max(1, (width + cellSize - 1) / cellSize);
+  rows = std::max(1, (height + cellSize - 1) / cellSize);
+  rects.clear();
+  entries.clear();
+  cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+}
+
+void SpatialGrid::cellRange(const SDL_Rect &rect, int &left, int &top, int &right, int &bottom) const
+{
+  left = std::min(std::max((rect.x - originX) / cellSize, 0), columns - 1);
+  top = std::min(std::max((rect.y - originY) / cellSize, 0), rows - 1);
+  right = std::min(std::max((rect.x + rect.w - 1 - originX) / cellSize, 0), columns - 1);
+  bottom = std::min(std::max((rect.y + rect.h - 1 - originY) / cellSize, 0), rows - 1);
+}
+
+void SpatialGrid::buildBuckets()
+{
+  std::fill(cellStart.begin(), cellStart.end(), 0);
+
+  // Count the objects per cell, shifted by one so the prefix sum gives the start of every bucket
+  for (const auto &rect : rects)
+  {
+    int left, top, right, bottom;
+    cellRange(rect, left, top, right, bottom);
+    for (int y = top; y <= bottom; ++y)
+    {
+      for (int x = left; x <= right; ++x)
+      {
+        cellStart[y * columns + x + 1]++;
+      }
+    }
+  }
+
+  for (size_t i = 1; i < cellStart.size(); ++i)
+  {
+    cellStart[i] += cellStart[i - 1];
+  }
+
+  // Place the indexes, objects are visited in order so every bucket ends up sorted
+  entries.resize(cellStart.back());
+  cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+  for (size_t index = 0; index < rects.size(); ++index)
+  {
+    int left, top, right, bottom;
+    cellRange(rects[index], left, top, right, bottom);
+    for (int y = top; y <= bottom; ++y)
+    {
+      for (int x = left; x <= right; ++x)
+      {
+        entries[cellFill[y * columns + x]++] = index;
+      }
+    }
+  }
+}
+
+void SpatialGrid::query(const SDL_Rect &area, std::vector<int> &indexes) const
+{
+  indexes.clear();
+
+  int left, top, right, bottom;
+  cellRange(area, left, top, right, bottom);
+  for (int y = top; y <= bottom; ++y)
+  {
+    for (int x = left; x <= right; ++x)
+    {
+      int cell = y * columns + x;
+      indexes.insert(indexes.end(), entries.begin() + cellStart[cell], entries.begin() + cellStart[cell + 1]);
+    }
+  }
+
+  // Objects overlapping several cells are found more than once
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
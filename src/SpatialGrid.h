@@ -0,0 +1,100 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <memory>
+
+/**
+ * @class SpatialGrid
+ * @brief Uniform grid of buckets for finding game objects near a position.
+ *
+ * The grid covers the game area with square cells and stores, for every cell, the indexes of the objects whose
+ * rectangle overlaps it. It is rebuilt from scratch with a counting sort: one pass counts the objects per cell, one
+ * pass places the indexes, so all buckets live in one contiguous array and a rebuild doesn't allocate once the
+ * buffers have grown.
+ *
+ * Queries return indexes into the vector the grid was built from, in ascending order, so callers visit nearby objects
+ * in the same order as a scan over the whole vector would.
+ */
+class SpatialGrid
+{
+public:
+  /**
+   * @brief Constructs an empty grid.
+   *
+   * @param cellSize The width and height of a cell in pixels.
+   */
+  SpatialGrid(int cellSize = 32);
+
+  /**
+   * @brief Sets the area covered by the grid.
+   *
+   * Objects outside the area are kept in the border cells.
+   *
+   * @param x The x-coordinate of the top-left corner of the area in pixels.
+   * @param y The y-coordinate of the top-left corner of the area in pixels.
+   * @param width The width of the area in pixels.
+   * @param height The height of the area in pixels.
+   */
+  void setArea(int x, int y, int width, int height);
+
+  /**
+   * @brief Rebuilds the buckets from a vector of game objects.
+   *
+   * @param objects The objects to index, queries return indexes into this vector.
+   */
+  template <typename Object>
+  void build(const std::vector<std::unique_ptr<Object>> &objects)
+  {
+    rects.clear();
+    for (const auto &object : objects)
+    {
+      std::pair<int, int> position = object->getPosition();
+      std::pair<int, int> size = object->getSize();
+      rects.push_back({position.first, position.second, size.first, size.second});
+    }
+    buildBuckets();
+  }
+
+  /**
+   * @brief Rebuilds the buckets from the rectangles of the objects.
+   *
+   * @param objectRects The rectangles to index, queries return indexes into this vector.
+   */
+  void build(const std::vector<SDL_Rect> &objectRects)
+  {
+    rects.assign(objectRects.begin(), objectRects.end());
+    buildBuckets();
+  }
+
+  /**
+   * @brief Finds the objects whose rectangle may overlap an area.
+   *
+   * @param area The area to search in pixels.
+   * @param indexes Output buffer, cleared and filled with the indexes of the objects in ascending order.
+   */
+  void query(const SDL_Rect &area, std::vector<int> &indexes) const;
+
+private:
+  /**
+   * @brief Fills the buckets from the collected rectangles with a counting sort.
+   */
+  void buildBuckets();
+
+  /**
+   * @brief Returns the range of cells overlapped by a rectangle, clamped to the grid.
+   */
+  void cellRange(const SDL_Rect &rect, int &left, int &top, int &right, int &bottom) const;
+
+  int cellSize;
+  int originX, originY;
+  int columns, rows;
+
+  std::vector<SDL_Rect> rects;
+  std::vector<int> cellStart;
+  std::vector<int> cellFill;
+  std::vector<int> entries;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "Game.h"
+
+void SpriteBatch::begin(const TextureAtlas &atlas)
+{
+  this->atlas = &atlas;
+  vertices.clear();
+  indices.clear();
+  quadCount = 0;
+}
+
+void SpriteBatch::addSprite(const SDL_Rect &source, const SDL_Rect &destination, SDL_Color color)
+{
+  SDL_FRect region = {static_cast<float>(source.x), static_cast<float>(source.y), static_cast<float>(source.w), static_cast<float>(source.h)};
+  addQuad(destination, region, color);
+}
+
+void SpriteBatch::addRect(const SDL_Rect &destination, SDL_Color color)
+{
+  if (destination.w <= 0 || destination.h <= 0)
+    return;
+
+  // Sample the middle of the white block only, so filtering never reaches a neighbouring sprite
+  const SDL_Rect &white = atlas->getWhiteRegion();
+  SDL_FRect region = {white.x + 1.0f, white.y + 1.0f, white.w - 2.0f, white.h - 2.0f};
+  addQuad(destination, region, color);
+}
+
+void SpriteBatch::addTexture(SDL_Texture *texture, const SDL_Rect &destination)
+{
+  flush();
+  SDL_RenderCopy(Game::renderer, texture, NULL, &destination);
+}
+
+void SpriteBatch::flush()
+{
+  if (indices.empty())
+    return;
+
+  SDL_RenderGeometry(Game::renderer, atlas->getTexture(), vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+  quadCount += indices.size() / 6;
+  vertices.clear();
+  indices.clear();
+}
+
+void SpriteBatch::addQuad(const SDL_Rect &destination, const SDL_FRect &source, SDL_Color color)
+{
+  float left = static_cast<float>(destination.x);
+  float top = static_cast<float>(destination.y);
+  float right = left + destination.w;
+  float bottom = top + destination.h;
+
+  float width = static_cast<float>(atlas->getWidth());
+  float height = static_cast<float>(atlas->getHeight());
+  float u0 = source.x / width;
+  float v0 = source.y / height;
+  float u1 = (source.x + source.w) / width;
+  float v1 = (source.y + source.h) / height;
+
+  int first = static_cast<int>(vertices.size());
+  vertices.push_back({{left, top}, color, {u0, v0}});
+  vertices.push_back({{right, top}, color, {u1, v0}});
+  vertices.push_back({{right, bottom}, color, {u1, v1}});
+  vertices.push_back({{left, bottom}, color, {u0, v1}});
+
+  const int corners[6] = {0, 1, 2, 0, 2, 3};
+  for (int corner : corners)
+  {
+    indices.push_back(first + corner);
+  }
+}
@@ -0,0 +1,82 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstddef>
+
+class TextureAtlas;
+
+/**
+ * @class SpriteBatch
+ * @brief Collects sprites of a texture atlas and plain rectangles and draws them with one SDL_RenderGeometry call.
+ *
+ * Every sprite or rectangle becomes a quad of two triangles. The quads are drawn in the order they were added, so a
+ * batch keeps the layering of the draw calls it replaces. The vertex buffers keep their memory between frames.
+ */
+class SpriteBatch
+{
+public:
+  /**
+   * @brief Starts a new batch drawing from an atlas, anything not flushed yet is dropped.
+   *
+   * @param atlas The atlas the sprites are taken from, it has to stay alive until the batch is flushed.
+   */
+  void begin(const TextureAtlas &atlas);
+
+  /**
+   * @brief Adds a sprite of the atlas.
+   *
+   * @param source The region of the sprite in the atlas.
+   * @param destination The rectangle the sprite is drawn to.
+   * @param color The color the sprite is multiplied with, white keeps its own colors.
+   */
+  void addSprite(const SDL_Rect &source, const SDL_Rect &destination, SDL_Color color = SDL_Color{255, 255, 255, 255});
+
+  /**
+   * @brief Adds a rectangle filled with a color.
+   *
+   * @param destination The rectangle to fill.
+   * @param color The color of the rectangle.
+   */
+  void addRect(const SDL_Rect &destination, SDL_Color color);
+
+  /**
+   * @brief Draws a texture that is not in the atlas.
+   *
+   * The batch is flushed first so the texture ends up above everything added before it.
+   *
+   * @param texture The texture to draw.
+   * @param destination The rectangle the texture is drawn to.
+   */
+  void addTexture(SDL_Texture *texture, const SDL_Rect &destination);
+
+  /**
+   * @brief Draws everything added since the last flush.
+   */
+  void flush();
+
+  /**
+   * @brief Returns the number of quads flushed since begin.
+   *
+   * @return size_t The number of sprites and rectangles.
+   */
+  size_t getQuadCount() const { return quadCount; }
+
+private:
+  /**
+   * @brief Appends a quad with texture coordinates in pixels of the atlas.
+   *
+   * @param destination The rectangle the quad covers on screen.
+   * @param source The rectangle of the quad in the atlas.
+   * @param color The color the texture is multiplied with.
+   */
+  void addQuad(const SDL_Rect &destination, const SDL_FRect &source, SDL_Color color);
+
+  const TextureAtlas *atlas = nullptr;
+  std::vector<SDL_Vertex> vertices;
+  std::vector<int> indices;
+  size_t quadCount = 0;
+};
+
+#endif
@@ -1,47 +1,25 @@
 #include "Text.h"
 #include "Game.h"
-#include <SDL2/SDL_ttf.h>
+#include <algorithm>
 
 Text::Text(std::string text, std::string fontPath, int fontSize, SDL_Color color, int x, int y)
-    : text(text), color(color), fontPath(fontPath), fontSize(fontSize)
+    : text(text), color(color)
 {
-  TTF_Font *font = Game::resourceManager.loadFont(fontPath, fontSize);
-  SDL_Surface *surface = TTF_RenderText_Solid(font, text.c_str(), color);
-  texture = SDL_CreateTextureFromSurface(Game::renderer, surface);
-  SDL_FreeSurface(surface);
-  Game::resourceManager.freeFont(fontPath, fontSize);
+  glyphs = Game::resourceManager.loadGlyphAtlas(fontPath, fontSize);
 
   rect.x = x;
   rect.y = y;
-  SDL_QueryTexture(texture, nullptr, nullptr, &rect.w, &rect.h);
+  measure();
 }
 
-void Text::setText(std::string newText)
+void Text::setText(const std::string &newText)
 {
   text = newText;
-
-  TTF_Font *font = Game::resourceManager.loadFont(fontPath, fontSize);
-  SDL_Surface *surface = TTF_RenderText_Solid(font, text.c_str(), color);
-
-  SDL_DestroyTexture(texture);
-
-  texture = SDL_CreateTextureFromSurface(Game::renderer, surface);
-
-  SDL_FreeSurface(surface);
-
-  Game::resourceManager.freeFont(fontPath, fontSize);
-
-  SDL_QueryTexture(texture, nullptr, nullptr, &rect.w, &rect.h);
+  measure();
 }
 
 SDL_Rect Text::getDimensions() const
 {
-  TTF_Font *font = Game::resourceManager.loadFont(fontPath, fontSize);
-  SDL_Rect rect;
-  if (font != nullptr)
-  {
-    TTF_SizeText(font, text.c_str(), &rect.w, &rect.h);
-  }
   return rect;
 }
 
@@ -51,12 +29,47 @@ void Text::setPosition(int x, int y)
   rect.y = y;
 }
 
-Text::~Text()
+void Text::measure()
 {
-  SDL_DestroyTexture(texture);
+  rect.w = 0;
+  rect.h = 0;
+  if (glyphs == nullptr)
+    return;
+
+  // Glyphs can reach past their advance, the last one decides how far the text really goes
+  int penX = 0;
+  for (char character : text)
+  {
+    const GlyphAtlas::Glyph *glyph = glyphs->getGlyph(character);
+    if (glyph == nullptr)
+      continue;
+
+    if (glyph->region)
+      rect.w = std::max(rect.w, penX + glyph->region->w);
+    penX += glyph->advance;
+  }
+  rect.w = std::max(rect.w, penX);
+  rect.h = glyphs->getLineHeight();
 }
 
 void Text::render()
 {
-  SDL_RenderCopy(Game::renderer, texture, nullptr, &rect);
-}
\ No newline at end of file
+  if (glyphs == nullptr)
+    return;
+
+  batch.begin(glyphs->getAtlas());
+
+  int penX = rect.x;
+  for (char character : text)
+  {
+    const GlyphAtlas::Glyph *glyph = glyphs->getGlyph(character);
+    if (glyph == nullptr)
+      continue;
+
+    if (glyph->region)
+      batch.addSprite(*glyph->region, SDL_Rect{penX, rect.y, glyph->region->w, glyph->region->h}, color);
+    penX += glyph->advance;
+  }
+
+  batch.flush();
+}
@@ -2,7 +2,8 @@
 #define TEXT_H
 
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
+#include "GlyphAtlas.h"
+#include "SpriteBatch.h"
 #include <string>
 
 /**
@@ -10,7 +11,8 @@
  * @brief Represents a rendered text on the screen.
  *
  * The Text class represents a rendered text on the screen. It provides functionality to create, update,
- * and render text using a specified font, font size, color, and position.
+ * and render text using a specified font, font size, color, and position. The characters are drawn as tinted quads
+ * from the glyph atlas of the font, so changing the text does not rasterize anything.
  */
 class Text
 {
@@ -20,7 +22,7 @@ public:
    *
    * This constructor creates a text object that can be rendered on the screen.
    * It takes the text string, font path, font size, color, and initial position as input,
-   * creates a texture from the text string, and sets the width and height of the rectangle
+   * looks up the glyph atlas of the font, and sets the width and height of the rectangle
    * that represents the text's position and dimensions on the screen.
    *
    * @param text The string that will be rendered.
@@ -32,13 +34,6 @@ public:
    */
   Text(std::string text, std::string fontPath, int fontSize, SDL_Color color, int x, int y);
 
-  /**
-   * @brief Destructor for the Text class.
-   *
-   * This destructor destroys the texture that was created for the text.
-   */
-  ~Text();
-
   /**
    * @brief Get the dimensions of the text.
    *
@@ -63,11 +58,11 @@ public:
    * @brief Update the text string.
    *
    * This function updates the text string that will be rendered on the screen,
-   * and re-creates the texture that represents the text.
+   * and measures its new width from the advances of its glyphs.
    *
    * @param newText The new text string.
    */
-  void setText(std::string newText);
+  void setText(const std::string &newText);
 
   /**
    * @brief Render the text.
@@ -78,12 +73,16 @@ public:
   void render();
 
 private:
+  /**
+   * @brief Sets the width and height of the text from its glyphs.
+   */
+  void measure();
+
   std::string text;
   SDL_Color color;
-  std::string fontPath;
-  int fontSize;
-  SDL_Texture *texture;
+  const GlyphAtlas *glyphs;
   SDL_Rect rect;
+  SpriteBatch batch;
 };
 
 #endif
\ No newline at end of file
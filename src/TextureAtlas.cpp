@@ -0,0 +1,132 @@
+#include "TextureAtlas.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstring>
+
+TextureAtlas::TextureAtlas() : texture(nullptr), width(0), height(0), whiteRegion{0, 0, 0, 0} {}
+
+TextureAtlas::~TextureAtlas()
+{
+  free();
+}
+
+bool TextureAtlas::build(SDL_Renderer *renderer, const std::vector<std::string> &paths)
+{
+  std::vector<std::pair<std::string, SDL_Surface *>> surfaces;
+  for (const auto &path : paths)
+  {
+    SDL_Surface *loaded = IMG_Load(path.c_str());
+    if (loaded != nullptr)
+      surfaces.emplace_back(path, loaded);
+  }
+
+  bool built = build(renderer, surfaces);
+
+  for (auto &surface : surfaces)
+  {
+    SDL_FreeSurface(surface.second);
+  }
+  return built;
+}
+
+bool TextureAtlas::build(SDL_Renderer *renderer, const std::vector<std::pair<std::string, SDL_Surface *>> &surfaces)
+{
+  free();
+
+  // Every sprite as 32 bit RGBA, the white block is packed like a sprite without a surface
+  struct Sprite
+  {
+    const std::string *path;
+    SDL_Surface *surface;
+    SDL_Rect region;
+  };
+  std::vector<Sprite> sprites;
+  for (const auto &surface : surfaces)
+  {
+    if (surface.second == nullptr)
+      continue;
+
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface.second, SDL_PIXELFORMAT_RGBA32, 0);
+    if (converted != nullptr)
+      sprites.push_back({&surface.first, converted, {0, 0, converted->w, converted->h}});
+  }
+  sprites.push_back({nullptr, nullptr, {0, 0, 4, 4}});
+
+  // Shelf packing, tall sprites first so every shelf holds sprites of similar height
+  std::sort(sprites.begin(), sprites.end(), [](const Sprite &a, const Sprite &b)
+            { return a.region.h > b.region.h; });
+
+  int x = 0, y = 0, shelfHeight = 0;
+  for (auto &sprite : sprites)
+  {
+    if (x > 0 && x + sprite.region.w + 2 * padding > maxWidth)
+    {
+      x = 0;
+      y += shelfHeight;
+      shelfHeight = 0;
+    }
+    sprite.region.x = x + padding;
+    sprite.region.y = y + padding;
+    x += sprite.region.w + 2 * padding;
+    shelfHeight = std::max(shelfHeight, sprite.region.h + 2 * padding);
+    width = std::max(width, x);
+  }
+  height = y + shelfHeight;
+
+  std::vector<Uint32> pixels(static_cast<size_t>(width) * height, 0);
+  for (auto &sprite : sprites)
+  {
+    const SDL_Rect &region = sprite.region;
+    for (int row = 0; row < region.h; ++row)
+    {
+      Uint32 *target = &pixels[static_cast<size_t>(region.y + row) * width + region.x];
+      if (sprite.surface)
+      {
+        const Uint8 *source = static_cast<const Uint8 *>(sprite.surface->pixels) + row * sprite.surface->pitch;
+        std::memcpy(target, source, region.w * sizeof(Uint32));
+      }
+      else
+      {
+        std::fill(target, target + region.w, 0xFFFFFFFF);
+      }
+    }
+
+    if (sprite.surface)
+    {
+      regions[*sprite.path] = region;
+      SDL_FreeSurface(sprite.surface);
+    }
+    else
+    {
+      whiteRegion = region;
+    }
+  }
+
+  texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, width, height);
+  if (texture == nullptr)
+  {
+    regions.clear();
+    return false;
+  }
+  SDL_UpdateTexture(texture, nullptr, pixels.data(), width * sizeof(Uint32));
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  return true;
+}
+
+void TextureAtlas::free()
+{
+  if (texture != nullptr)
+  {
+    SDL_DestroyTexture(texture);
+    texture = nullptr;
+  }
+  regions.clear();
+  width = 0;
+  height = 0;
+}
+
+const SDL_Rect *TextureAtlas::find(const std::string &path) const
+{
+  auto it = regions.find(path);
+  return it != regions.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,109 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @class TextureAtlas
+ * @brief One texture holding many small sprites, so they can be drawn together in a single batch.
+ *
+ * The sprites are loaded once, packed into rows of similar height and uploaded as one texture. Next to the sprites the
+ * atlas holds a small white block, which SpriteBatch stretches and tints to draw plain rectangles like health bars
+ * without switching textures.
+ */
+class TextureAtlas
+{
+public:
+  /**
+   * @brief Constructs an empty atlas, no sprite is found in it until it is built.
+   */
+  TextureAtlas();
+
+  /**
+   * @brief Destroys the texture of the atlas.
+   */
+  ~TextureAtlas();
+
+  TextureAtlas(const TextureAtlas &) = delete;
+  TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+  /**
+   * @brief Loads the sprites and packs them into the atlas texture, replacing the sprites of an earlier build.
+   *
+   * Sprites that fail to load are left out, objects using them fall back to their own texture.
+   *
+   * @param renderer The renderer the texture is created for.
+   * @param paths Paths of the sprite images.
+   * @return bool True if the atlas texture was created, false otherwise.
+   */
+  bool build(SDL_Renderer *renderer, const std::vector<std::string> &paths);
+
+  /**
+   * @brief Packs sprites that are already in memory into the atlas texture, replacing the sprites of an earlier build.
+   *
+   * The surfaces are copied, they still belong to the caller afterwards. Null surfaces are left out.
+   *
+   * @param renderer The renderer the texture is created for.
+   * @param surfaces The name each sprite is found by and its surface.
+   * @return bool True if the atlas texture was created, false otherwise.
+   */
+  bool build(SDL_Renderer *renderer, const std::vector<std::pair<std::string, SDL_Surface *>> &surfaces);
+
+  /**
+   * @brief Destroys the texture and forgets all sprites.
+   */
+  void free();
+
+  /**
+   * @brief Finds the region of a sprite in the atlas.
+   *
+   * The returned pointer stays valid until the atlas is built again or freed.
+   *
+   * @param path The path the sprite was loaded from, or the name it was packed with.
+   * @return const SDL_Rect* The region of the sprite in pixels, nullptr if the sprite is not in the atlas.
+   */
+  const SDL_Rect *find(const std::string &path) const;
+
+  /**
+   * @brief Returns the atlas texture.
+   *
+   * @return SDL_Texture* The texture, nullptr if the atlas was not built.
+   */
+  SDL_Texture *getTexture() const { return texture; }
+
+  /**
+   * @brief Returns the width of the atlas texture.
+   *
+   * @return int The width in pixels.
+   */
+  int getWidth() const { return width; }
+
+  /**
+   * @brief Returns the height of the atlas texture.
+   *
+   * @return int The height in pixels.
+   */
+  int getHeight() const { return height; }
+
+  /**
+   * @brief Returns the block of white pixels used for plain rectangles.
+   *
+   * @return const SDL_Rect& The region of the block in pixels.
+   */
+  const SDL_Rect &getWhiteRegion() const { return whiteRegion; }
+
+private:
+  static const int maxWidth = 512;
+  static const int padding = 1;
+
+  SDL_Texture *texture;
+  int width, height;
+  SDL_Rect whiteRegion;
+  std::unordered_map<std::string, SDL_Rect> regions;
+};
+
+#endif
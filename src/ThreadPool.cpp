@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : task(nullptr), taskCount(0), taskChunks(0), taskGeneration(0), busyWorkers(0), nextChunk(0), finishedChunks(0), stopping(false)
+{
+  if (threadCount == 0)
+  {
+    // The calling thread works on the chunks as well
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+  }
+
+  for (unsigned int i = 0; i < threadCount; ++i)
+  {
+    workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  taskAvailable.notify_all();
+
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, const Task &task)
+{
+  size_t chunks = std::min(getMaxChunks(), (count + minChunkSize - 1) / minChunkSize);
+  if (chunks <= 1)
+  {
+    if (count > 0)
+      task(0, 0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->task = &task;
+    taskCount = count;
+    taskChunks = chunks;
+    nextChunk = 0;
+    finishedChunks = 0;
+    ++taskGeneration;
+  }
+  taskAvailable.notify_all();
+
+  runChunks();
+
+  // Workers still inside runChunks may read the task, it has to outlive them
+  std::unique_lock<std::mutex> lock(mutex);
+  taskFinished.wait(lock, [this]()
+                    { return finishedChunks == taskChunks && busyWorkers == 0; });
+  this->task = nullptr;
+}
+
+void ThreadPool::runChunks()
+{
+  while (true)
+  {
+    size_t chunk = nextChunk++;
+    if (chunk >= taskChunks)
+      return;
+
+    // Chunk boundaries only depend on the count, never on which thread takes the chunk
+    size_t begin = taskCount * chunk / taskChunks;
+    size_t end = taskCount * (chunk + 1) / taskChunks;
+    (*task)(chunk, begin, end);
+
+    if (++finishedChunks == taskChunks)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      taskFinished.notify_all();
+    }
+  }
+}
+
+void ThreadPool::work()
+{
+  uint64_t seenGeneration = 0;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      taskAvailable.wait(lock, [this, seenGeneration]()
+                         { return stopping || (task != nullptr && taskGeneration != seenGeneration); });
+      if (stopping)
+        return;
+
+      seenGeneration = taskGeneration;
+      ++busyWorkers;
+    }
+
+    runChunks();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      --busyWorkers;
+    }
+    taskFinished.notify_all();
+  }
+}
@@ -0,0 +1,86 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class ThreadPool
+ * @brief Runs loops over a range of indexes on worker threads.
+ *
+ * The range is split into contiguous chunks in index order, the calling thread works on chunks too and returns once
+ * all of them are done. A task that only writes to its own indexes, or to a buffer of its chunk, produces the same
+ * result however many threads there are, because the chunks can be read back in order.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief The task run for every chunk, with the chunk number and the range [begin, end) of its indexes.
+   */
+  using Task = std::function<void(size_t chunk, size_t begin, size_t end)>;
+
+  /**
+   * @brief Starts the worker threads.
+   *
+   * @param threadCount The number of worker threads, 0 picks one less than the number of hardware threads.
+   */
+  explicit ThreadPool(unsigned int threadCount = 0);
+
+  /**
+   * @brief Stops and joins the worker threads.
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief Runs a task over the indexes [0, count) and waits for it to finish.
+   *
+   * Ranges too small to be worth splitting run on the calling thread as a single chunk.
+   *
+   * @param count The number of indexes.
+   * @param task The task to run for every chunk.
+   */
+  void parallelFor(size_t count, const Task &task);
+
+  /**
+   * @brief Returns the highest number of chunks a range is split into, chunk numbers are always below it.
+   *
+   * @return size_t The number of worker threads plus the calling thread.
+   */
+  size_t getMaxChunks() const { return workers.size() + 1; }
+
+private:
+  static const size_t minChunkSize = 64;
+
+  /**
+   * @brief Takes chunks of the current task until none are left.
+   */
+  void runChunks();
+
+  /**
+   * @brief Main loop of a worker thread, helps with every task until the pool is stopped.
+   */
+  void work();
+
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable taskAvailable;
+  std::condition_variable taskFinished;
+  const Task *task;
+  size_t taskCount;
+  size_t taskChunks;
+  uint64_t taskGeneration;
+  unsigned int busyWorkers;
+  std::atomic<size_t> nextChunk;
+  std::atomic<size_t> finishedChunks;
+  bool stopping;
+};
+
+#endif
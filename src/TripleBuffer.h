@@ -0,0 +1,60 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ * @brief Hands values from one producer thread to one consumer thread without either of them waiting.
+ *
+ * The producer fills the write buffer and publishes it, the consumer reads the newest published buffer. The third
+ * buffer sits between them, so a publish never touches the buffer being read and a read never touches the one being
+ * written. Buffers are swapped, not copied, so their memory is reused from one round to the next.
+ *
+ * @tparam T The type of the values, default constructible.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+  /**
+   * @brief Returns the buffer the producer fills next, it keeps the contents of an older round.
+   *
+   * @return T& The write buffer, only to be used by the producer.
+   */
+  T &write() { return buffers[writeIndex]; }
+
+  /**
+   * @brief Hands the write buffer to the consumer and takes another one to write into next.
+   */
+  void publish()
+  {
+    writeIndex = middle.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+  }
+
+  /**
+   * @brief Takes the newest published buffer if there is one the consumer has not seen yet.
+   *
+   * @return const T& The newest buffer, it stays valid until the next call of read. Default constructed if nothing
+   * was published yet.
+   */
+  const T &read()
+  {
+    if (middle.load(std::memory_order_relaxed) & freshBit)
+    {
+      readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+    }
+    return buffers[readIndex];
+  }
+
+private:
+  static const int indexMask = 3;
+  static const int freshBit = 4;
+
+  T buffers[3];
+  int writeIndex = 0;
+  std::atomic<int> middle{1};
+  int readIndex = 2;
+};
+
+#endif
@@ -1,166 +1,141 @@
 #include "Game.h"
 #include "Unit.h"
 #include "Map.h"
+#include "FlowField.h"
+#include "PathQueue.h"
 #include "utils.h"
 #include <cmath>
 #include <utility>
 
-Unit::Unit(int x, int y, int width, int height, std::string type, int health, float speed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
+Unit::Unit(int x, int y, int width, int height, UnitType type, int health, float speed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
     : GameObject(x, y, width, height),
-      type(type),
-      force(0.0f, 0.0f),
-      health(health),
-      maxHealth(health),
-      speed(speed),
-      ownerId(ownerId),
-      radius(radius),
+      store(LevelScene::getUnitStore()),
       allUnits(allUnits),
       unitsToRemove(unitsToRemove),
       allWalls(allWalls),
       allResources(allResources),
-      allCastles(allCastles),
-      lastInteraction(0)
+      allCastles(allCastles)
 {
-  actualX = x;
-  actualY = y;
+  slot = store.add(this, objectRect, type, health, speed, ownerId, radius, 0);
 }
 
-void Unit::render()
+Unit::~Unit()
 {
-  if (texture != nullptr)
+  store.remove(slot);
+}
+
+void *Unit::operator new(size_t size)
+{
+  return LevelScene::getLevelArena().allocateObject(size);
+}
+
+void Unit::operator delete(void *memory)
+{
+  Arena::freeObject(memory);
+}
+
+void Unit::update()
+{
+  nextStep();
+  handleCollisions();
+
+  if (store.forceX[slot] != 0.0f || store.forceY[slot] != 0.0f)
   {
-    SDL_RenderCopy(Game::renderer, texture, NULL, &objectRect);
+    applyForce();
   }
 
-  // Create a rectangle for the total health (red)
-  SDL_Rect healthBarRect;
-  healthBarRect.x = objectRect.x;
-  healthBarRect.y = objectRect.y - 6; // Position it 6px above the unit
-  healthBarRect.w = 16;
-  healthBarRect.h = 4;
-
-  // Render the total health bar (red)
-  SDL_SetRenderDrawColor(Game::renderer, 255, 0, 0, 255);
-  SDL_RenderFillRect(Game::renderer, &healthBarRect);
+  uint32_t now = Game::tick;
+  if (Game::ticksToMilliseconds(now - store.lastInteractions[slot]) >= store.interactionIntervals[slot])
+  {
+    store.lastInteractions[slot] = now;
+    interact();
+  }
+}
 
-  // Create a rectangle for the current health (green)
-  SDL_Rect currentHealthRect;
-  currentHealthRect.x = objectRect.x;
-  currentHealthRect.y = objectRect.y - 6;                      // Position it 6px above the unit
-  currentHealthRect.w = (int)((float)health / maxHealth * 16); // Scale it according to the current health percentage
-  currentHealthRect.h = 4;
+void Unit::interact()
+{
+  uint64_t random = randomStream(Game::tick, store.ids[slot]);
+  UnitIntent intent;
+  if (planInteraction(random, intent))
+  {
+    applyInteraction(intent);
+  }
+}
 
-  // Render the current health bar (green)
-  SDL_SetRenderDrawColor(Game::renderer, 0, 255, 0, 255);
-  SDL_RenderFillRect(Game::renderer, &currentHealthRect);
+void Unit::capture(RenderSnapshot::Sprite &target) const
+{
+  target.previous = store.previousPositions[slot];
+  target.rect = store.rects[slot];
+  target.region = sprite;
+  target.texture = texture;
+  target.health = store.health[slot];
+  target.maxHealth = store.maxHealth[slot];
+  target.healthBarWidth = 16;
 }
 
-void Unit::moveTo(int targetX, int targetY)
+void Unit::savePreviousPosition()
 {
-  calculatePath(targetX, targetY);
+  store.previousPositions[slot] = {store.rects[slot].x, store.rects[slot].y};
 }
 
-void Unit::handleCollisions()
+void Unit::setPosition(int x, int y)
 {
+  store.rects[slot].x = x;
+  store.rects[slot].y = y;
+  store.x[slot] = x;
+  store.y[slot] = y;
+  store.resetSteering(slot);
+}
 
-  for (auto &unit : allUnits)
-  {
-    // Skip self
-    if (this == unit.get())
-      continue;
-
-    // If units are intersecting
-    if (checkCollision(*unit))
-    {
-      if (this < unit.get())
-      {
-        separate(*unit);
-      }
-    }
-  }
+std::pair<int, int> Unit::getPosition() const
+{
+  return {store.rects[slot].x, store.rects[slot].y};
 }
 
-void Unit::separate(Unit &other)
+const SDL_Rect &Unit::getRect() const
 {
-  // Separate units based on their centers and their size
-  auto pos1 = getPosition();
-  auto pos2 = other.getPosition();
-  float dx = pos2.first - pos1.first;
-  float dy = pos2.second - pos1.second;
-  float distance = std::sqrt(dx * dx + dy * dy);
+  return store.rects[slot];
+}
 
-  float size1 = getSize().first / 2.0;
-  float size2 = other.getSize().first / 2.0;
+int Unit::getSlot() const { return slot; }
 
-  float overlap = (size1 + size2) - distance;
+UnitHandle Unit::getHandle() const { return store.handleOf(slot); }
 
-  // Normalize
-  if (distance > 0)
-  {
-    dx /= distance;
-    dy /= distance;
-  }
+void Unit::setSlot(int newSlot) { slot = newSlot; }
 
-  // Add some randomness to the direction of the force for each unit
-  int randomAngle1 = randomInt(-30, 30);                    // This will give us a random angle between -30 and 30 degrees for this unit
-  int randomAngle2 = randomInt(-30, 30);                    // This will give us a random angle between -30 and 30 degrees for the other unit
-  float randomAngleRadians1 = randomAngle1 * M_PI / 180.0f; // Convert to radians
-  float randomAngleRadians2 = randomAngle2 * M_PI / 180.0f; // Convert to radians
-  float newDx1 = dx * cos(randomAngleRadians1) - dy * sin(randomAngleRadians1);
-  float newDy1 = dx * sin(randomAngleRadians1) + dy * cos(randomAngleRadians1);
-  float newDx2 = dx * cos(randomAngleRadians2) - dy * sin(randomAngleRadians2);
-  float newDy2 = dx * sin(randomAngleRadians2) + dy * cos(randomAngleRadians2);
-  dx = newDx1;
-  dy = newDy1;
-
-  // Apply a unique force to each unit
-  float randomFactor1 = randomInt(50, 300) / 100.0f;
-  float randomFactor2 = randomInt(50, 300) / 100.0f;
-
-  force.first -= overlap * randomFactor1 * dx;
-  force.second -= overlap * randomFactor1 * dy;
-  dx = newDx2;
-  dy = newDy2;
-
-  other.force.first += overlap * randomFactor2 * dx;
-  other.force.second += overlap * randomFactor2 * dy;
-
-  float stationaryResistance = 0.8;
-
-  if (isMoving() && !other.isMoving())
-  {
-    force.first = 0;
-    force.second = 0;
-    if (randomFactor2 > 2)
-    {
-      other.force.first *= stationaryResistance;
-      other.force.second *= stationaryResistance;
-    }
-  }
+void Unit::setInteractionInterval(uint32_t interval)
+{
+  store.interactionIntervals[slot] = interval;
+}
 
-  if (other.isMoving() && !isMoving())
-  {
-    other.force.first = 0;
-    other.force.second = 0;
-    if (randomFactor1 > 2)
-    {
-      force.first *= stationaryResistance;
-      force.second *= stationaryResistance;
-    }
-  }
+void Unit::moveTo(int targetX, int targetY)
+{
+  calculatePath(targetX, targetY);
+}
+
+void Unit::handleCollisions()
+{
+  store.separateFromNeighbours(slot, LevelScene::getUnitGrid());
+}
+
+void Unit::separate(Unit &other)
+{
+  store.separate(slot, other.slot);
 }
 
 void Unit::stopMovement()
 {
   // Clear path
-  path.clear();
+  cancelPathRequest();
+  store.paths[slot].clear();
+  store.waypoints[slot].clear();
 }
 
 void Unit::calculatePath(int targetX, int targetY)
 {
   // Convert pixel coordinates to grid indexes for path calculation
-  int gridStartX = actualX / 16;
-  int gridStartY = (actualY - 88) / 16;
+  int gridStartX = store.x[slot] / 16;
+  int gridStartY = (store.y[slot] - 88) / 16;
   int gridTargetX = targetX / 16;
   int gridTargetY = (targetY - 88) / 16;
 
@@ -169,81 +144,72 @@ void Unit::calculatePath(int targetX, int targetY)
     return;
   }
 
-  // Get the path from the A* algorithm
-  std::list<std::pair<int, int>> gridPath = LevelScene::getMap().calculatePath(std::make_pair(gridStartX, gridStartY), std::make_pair(gridTargetX, gridTargetY));
+  // Wait in the pathing state until the path queue solves the request
+  cancelPathRequest();
+  store.paths[slot].clear();
+  store.waypoints[slot].clear();
+  store.pathTickets[slot] = LevelScene::getPathQueue().request(getHandle(), std::make_pair(gridStartX, gridStartY), std::make_pair(gridTargetX, gridTargetY));
+}
 
-  // Convert grid indexes to pixel coordinates for movement
-  path.clear();
-  for (const auto &cell : gridPath)
-  {
-    int pixelX = cell.first * 16;
-    int pixelY = cell.second * 16 + 88; // account for offset of game area
-    path.push_back(std::make_pair(pixelX, pixelY));
-  }
-  if (!path.empty())
+void Unit::applyPathResult(uint32_t ticket, const WaypointBuffer &gridPath, const WaypointBuffer &waypoints)
+{
+  if (ticket != store.pathTickets[slot])
+    return;
+
+  store.pathTickets[slot] = 0;
+  setGridPath(gridPath);
+  store.waypoints[slot] = waypoints;
+}
+
+void Unit::refineNextWaypoint()
+{
+  store.refineNextWaypoint(slot);
+}
+
+void Unit::cancelPathRequest()
+{
+  uint32_t &pathTicket = store.pathTickets[slot];
+  if (pathTicket != 0)
   {
-    path.pop_front();
+    LevelScene::getPathQueue().cancel(pathTicket);
+    pathTicket = 0;
   }
 }
 
-void Unit::nextStep()
+void Unit::followFlowField(const FlowField &flowField)
 {
-  // If unit is under influence of a force, don't execute the path following behavior
-  if (force.first != 0.0f || force.second != 0.0f)
-    return;
+  int gridStartX = store.x[slot] / 16;
+  int gridStartY = (store.y[slot] - 88) / 16;
 
-  if (!path.empty())
+  cancelPathRequest();
+  store.waypoints[slot].clear();
+  if (flowField.isGoal(gridStartX, gridStartY))
   {
-    auto next = path.front();
-
-    float nextX = next.first;
-    float nextY = next.second;
-
-    // Calculate direction
-    float dx = nextX - actualX;
-    float dy = nextY - actualY;
-    float magnitude = std::sqrt(dx * dx + dy * dy);
-    dx /= magnitude;
-    dy /= magnitude;
-
-    // Apply force to the calculated movement direction
-    dx += force.first;
-    dy += force.second;
-
-    // Move the unit
-    actualX += dx * speed;
-    actualY += dy * speed;
-
-    // Update objectRect for rendering
-    objectRect.x = (int)actualX;
-    objectRect.y = (int)actualY;
-
-    // Check if we reached the target tile
-    if (std::abs(actualX - nextX) < speed && std::abs(actualY - nextY) < speed)
-    {
-      path.pop_front();
-      if (path.empty())
-      {
-        if (objectRect.x % 16 != 0)
-        {
-          objectRect.x += 16 - (objectRect.x % 16);
-          actualX += speed;
-        }
-        if ((objectRect.y - 88) % 16 != 0)
-        {
-          objectRect.y += 16 - ((objectRect.y - 88) % 16);
-          actualY += speed;
-        }
-      }
-    }
+    return;
   }
+
+  thread_local WaypointBuffer corners;
+  thread_local WaypointBuffer gridPath;
+  flowField.tracePath(gridStartX, gridStartY, corners);
+  LevelScene::getMap().smoothPath(corners, gridPath);
+  setGridPath(gridPath);
+}
+
+void Unit::setGridPath(const WaypointBuffer &gridPath)
+{
+  store.setGridPath(slot, gridPath);
+}
+
+void Unit::nextStep()
+{
+  store.followPath(slot);
 }
 
 std::pair<float, float> Unit::getNextTarget() const
 {
-  if (!path.empty())
+  if (!store.paths[slot].empty())
   {
-    return path.front();
+    return store.paths[slot].front();
   }
   else
   {
@@ -253,6 +219,7 @@ std::pair<float, float> Unit::getNextTarget() const
 
 void Unit::takeDamage(int damage)
 {
+  int &health = store.health[slot];
   health -= damage;
   if (health <= 0)
   {
@@ -262,90 +229,39 @@ void Unit::takeDamage(int damage)
 
 bool Unit::isMoving() const
 {
-  return !path.empty();
+  return store.isMoving(slot);
+}
+
+bool Unit::isPathing() const
+{
+  return store.pathTickets[slot] != 0;
 }
 
 bool Unit::isAlive() const
 {
-  return health > 0;
+  return store.health[slot] > 0;
 };
 
 void Unit::invertForce()
 {
-  force.first = -force.first;
-  force.second = -force.second;
+  store.forceX[slot] = -store.forceX[slot];
+  store.forceY[slot] = -store.forceY[slot];
 }
 
 void Unit::applyForce()
 {
-  // create a "virtual unit" that represents the next position
-  Unit *virtualUnit = this->clone();
-  virtualUnit->actualX += force.first * 0.05;
-  virtualUnit->actualY += force.second * 0.05;
-  bool willCollideWithObject = virtualUnit->checkCollisions();
-
-  if (!willCollideWithObject)
-  {
-    actualX = virtualUnit->actualX;
-    actualY = virtualUnit->actualY;
-
-    objectRect.x = (int)actualX;
-    objectRect.y = (int)actualY;
-
-    force.first -= force.first * 0.05;
-    force.second -= force.second * 0.05;
-  }
-  else
-  {
-    // invert force direction if collision would occur
-    force.first = -force.first;
-    force.second = -force.second;
-
-    actualX += force.first * 0.05;
-    actualY += force.second * 0.05;
-
-    objectRect.x = (int)actualX;
-    objectRect.y = (int)actualY;
-
-    force.first -= force.first * 0.05;
-    force.second -= force.second * 0.05;
-  }
-
-  if (std::abs(force.first) < 0.1 && std::abs(force.second) < 0.1)
-  {
-    force.first = 0.0f;
-    force.second = 0.0f;
-  }
-  delete virtualUnit;
+  store.applyForce(slot);
 }
 
 bool Unit::checkCollisions()
 {
-  for (auto &wall : allWalls)
-  {
-    if (checkCollision(*wall))
-    {
-      return true;
-    }
-  }
-
-  for (auto &castle : allCastles)
-  {
-    if (checkCollision(*castle))
-    {
-      return true;
-    }
-  }
-
-  for (auto &resource : allResources)
-  {
-    if (checkCollision(*resource))
-    {
-      return true;
-    }
-  }
+  // Walls, castles and resources are all in the collision map of the level
+  return LevelScene::getCollisionMap().collides(store.rects[slot]);
+}
 
-  return false;
+bool Unit::checkCollisionsAt(float x, float y) const
+{
+  return store.collidesAt(slot, x, y);
 }
 
 bool Unit::isInRange(const GameObject &target) const
@@ -379,27 +295,40 @@ bool Unit::isInRange(const GameObject &target) const
   float dy = thisPos.second - closestY;
   float distance = std::sqrt(dx * dx + dy * dy);
 
-  return distance <= radius * 16;
+  return distance <= store.radius[slot] * 16;
 }
 
 void Unit::die()
 {
-  unitsToRemove.push_back(this);
-}
-
-int Unit::getHealth() const { return health; };
-void Unit::setHealth(int newHealth) { health = newHealth; };
-float Unit::getSpeed() const { return speed; };
-void Unit::setSpeed(float newSpeed) { speed = newSpeed; };
-int Unit::getOwnerId() const { return ownerId; };
-void Unit::setOwnerId(int newOwnerId) { ownerId = newOwnerId; };
-float Unit::getRadius() const { return radius; };
-void Unit::setRadius(float newRadius) { radius = newRadius; };
-float Unit::getActualX() const { return actualX; };
-void Unit::setActualX(float x) { actualX = x; };
-float Unit::getActualY() const { return actualY; };
-void Unit::setActualY(float y) { actualY = y; };
-std::string Unit::getType() const { return type; };
-void Unit::setType(std::string newType) { type = newType; };
-std::pair<float, float> Unit::getForce() const { return force; };
-void Unit::setForce(std::pair<float, float> f) { force = f; };
\ No newline at end of file
+  cancelPathRequest();
+  unitsToRemove.push_back(getHandle());
+}
+
+int Unit::getHealth() const { return store.health[slot]; };
+void Unit::setHealth(int newHealth) { store.health[slot] = newHealth; };
+float Unit::getSpeed() const { return store.speed[slot]; };
+void Unit::setSpeed(float newSpeed) { store.speed[slot] = newSpeed; };
+int Unit::getOwnerId() const { return store.owners[slot]; };
+void Unit::setOwnerId(int newOwnerId) { store.owners[slot] = newOwnerId; };
+float Unit::getRadius() const { return store.radius[slot]; };
+void Unit::setRadius(float newRadius) { store.radius[slot] = newRadius; };
+float Unit::getActualX() const { return store.x[slot]; };
+void Unit::setActualX(float x)
+{
+  store.x[slot] = x;
+  store.resetSteering(slot);
+};
+float Unit::getActualY() const { return store.y[slot]; };
+void Unit::setActualY(float y)
+{
+  store.y[slot] = y;
+  store.resetSteering(slot);
+};
+UnitType Unit::getType() const { return store.types[slot]; };
+void Unit::setType(UnitType newType) { store.types[slot] = newType; };
+std::pair<float, float> Unit::getForce() const { return {store.forceX[slot], store.forceY[slot]}; };
+void Unit::setForce(std::pair<float, float> f)
+{
+  store.forceX[slot] = f.first;
+  store.forceY[slot] = f.second;
+};
\ No newline at end of file
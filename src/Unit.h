@@ -6,11 +6,14 @@
 #include "Wall.h"
 #include "Resource.h"
 #include "Castle.h"
-#include <list>
+#include "UnitStore.h"
+#include "RenderSnapshot.h"
 #include <vector>
 #include <memory>
 #include <utility>
 
+class FlowField;
+
 /**
  * @class Unit
  * @brief Represents a game unit in the game world.
@@ -18,6 +21,10 @@
  * The Unit class is a base class for game units in the game world. It inherits from the GameObject class
  * and provides functionality for units' movement, collision detection, health management, and interaction with other game objects.
  * Derived classes can extend this class to implement specific types of units with additional behavior and properties.
+ *
+ * The simulation state of a unit (position, forces, health, owner, timers and path) lives in its slot of the level's
+ * UnitStore, the unit object is a handle to that slot. The level updates all units at once with the kernels of the
+ * store, update runs the same steps for this unit alone.
  */
 class Unit : public GameObject
 {
@@ -39,35 +46,147 @@ public:
    * @param allResources A reference to a vector containing all resources in the game.
    * @param allCastles A reference to a vector containing all castles in the game.
    */
-  Unit(int x, int y, int width, int height, std::string type, int health, float speed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
+  Unit(int x, int y, int width, int height, UnitType type, int health, float speed, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
+
+  /**
+   * @brief Virtual destructor for the Unit class, frees the slot of the unit.
+   */
+  virtual ~Unit();
+
+  Unit(const Unit &) = delete;
+  Unit &operator=(const Unit &) = delete;
+
+  /**
+   * @brief Allocates soldiers and workers in the arena of the level instead of one by one on the heap.
+   *
+   * @param size The size of the unit.
+   * @return void* The memory of the unit.
+   */
+  static void *operator new(size_t size);
+
+  /**
+   * @brief Gives the memory of a unit back to the arena of its level, where the next unit of the same kind reuses it.
+   *
+   * @param memory The memory of the unit.
+   */
+  static void operator delete(void *memory);
+
+  /**
+   * @brief Runs one tick of the unit: follows the path, separates from other units, applies the force and attacks or
+   * gathers when its timer expired.
+   */
+  void update() override;
+
+  /**
+   * @brief Performs the periodic action of the unit, called each time its interaction interval has passed.
+   *
+   * Plans the action and carries it out right away, the level does both steps for all units at once instead.
+   */
+  void interact();
+
+  /**
+   * @brief Decides on the periodic action of the unit without changing any object.
+   *
+   * Called for many units at once on several threads, so only the unit's own random stream may be used.
+   *
+   * @param random The random stream of the unit for this tick.
+   * @param intent Set to the action of the unit.
+   * @return true if the unit acts, false if there is nothing to act on in range.
+   */
+  virtual bool planInteraction(uint64_t &random, UnitIntent &intent) const = 0;
+
+  /**
+   * @brief Carries out an action decided on by planInteraction.
+   *
+   * @param intent The action to carry out.
+   */
+  virtual void applyInteraction(const UnitIntent &intent) = 0;
+
+  /**
+   * @brief Copies what is needed to draw the Unit and its health bar into a render snapshot.
+   *
+   * The positions before and after the last tick are both kept, the unit is drawn between them.
+   *
+   * @param target The sprite of the snapshot to fill.
+   */
+  void capture(RenderSnapshot::Sprite &target) const;
+
+  /**
+   * @brief Remembers the current position as the start of the next simulation tick.
+   *
+   * Rendering interpolates between this position and the position after the tick.
+   */
+  void savePreviousPosition();
+
+  /**
+   * @brief Moves the unit to a position in whole pixels.
+   *
+   * @param x The new x-coordinate of the unit.
+   * @param y The new y-coordinate of the unit.
+   */
+  void setPosition(int x, int y) override;
+
+  /**
+   * @brief Retrieves the position of the unit in whole pixels, from its slot.
+   *
+   * @return A std::pair where first is the x-coordinate and second is the y-coordinate.
+   */
+  std::pair<int, int> getPosition() const override;
 
   /**
-   * @brief Virtual destructor for the Unit class.
+   * @brief Retrieves the bounding rectangle of the unit, from its slot.
+   *
+   * @return The rectangle of the unit in pixels.
    */
-  virtual ~Unit() = default;
+  const SDL_Rect &getRect() const override;
 
   /**
-   * @brief Renders the Unit on the screen.
+   * @brief Returns the slot of the unit in the unit store.
    *
-   * This method takes care of rendering the Unit object and its health bar on the screen.
+   * Slots change when other units are removed.
+   *
+   * @return int The slot of the unit.
    */
-  void render() override;
+  int getSlot() const;
 
   /**
-   * @brief Pure virtual clone method.
+   * @brief Returns a handle to the unit, for keeping it across ticks.
    *
-   * Derived classes must provide an implementation to clone unit.
+   * @return UnitHandle The handle, it becomes invalid when the unit is removed.
    */
-  virtual Unit *clone() const = 0;
+  UnitHandle getHandle() const;
 
   /**
    * @brief Initiates movement of the Unit towards the given target coordinates.
    *
+   * The path is requested from the path queue, the unit stays in the pathing state until the result is applied.
+   * A pending request from an earlier order is cancelled.
+   *
    * @param targetX The x-coordinate of the target location in pixels.
    * @param targetY The y-coordinate of the target location in pixels.
    */
   void moveTo(int targetX, int targetY);
 
+  /**
+   * @brief Initiates movement of the Unit along a shared flow field.
+   *
+   * Used for group orders, the path is traced from the flow field instead of running a search for every unit.
+   *
+   * @param flowField The flow field leading to the destination.
+   */
+  void followFlowField(const FlowField &flowField);
+
+  /**
+   * @brief Applies a path solved by the path queue.
+   *
+   * Results of requests that were superseded by a newer order are ignored.
+   *
+   * @param ticket The ticket of the solved request.
+   * @param gridPath The corners of the path in grid coordinates, starting with the tile of the unit.
+   * @param waypoints Abstract waypoints following the path, refined one at a time as the unit walks.
+   */
+  void applyPathResult(uint32_t ticket, const WaypointBuffer &gridPath, const WaypointBuffer &waypoints);
+
   /**
    * @brief Applies damage to the Unit and handles its death if health drops below or equal to zero.
    *
@@ -89,6 +208,17 @@ public:
    */
   bool checkCollisions();
 
+  /**
+   * @brief Checks if there would be any collisions with static objects at a different position.
+   *
+   * The unit itself is not moved and nothing is allocated.
+   *
+   * @param x The x-coordinate of the position to test.
+   * @param y The y-coordinate of the position to test.
+   * @return true if the Unit would collide at the position, false otherwise.
+   */
+  bool checkCollisionsAt(float x, float y) const;
+
   /**
    * @brief Checks if the given target is within the range of the Unit.
    *
@@ -98,7 +228,7 @@ public:
   bool isInRange(const GameObject &target) const;
 
   /**
-   * @brief Separates this Unit from another given Unit.
+   * @brief Pushes this Unit away from another given Unit, the other Unit is not moved.
    *
    * @param other Reference to the other Unit with which separation should occur.
    */
@@ -122,7 +252,7 @@ public:
   std::pair<float, float> getNextTarget() const;
 
   /**
-   * @brief Stops the movement of the Unit.
+   * @brief Stops the movement of the Unit and cancels its pending path request.
    */
   void stopMovement();
 
@@ -140,6 +270,13 @@ public:
    */
   bool isMoving() const;
 
+  /**
+   * @brief Checks if the Unit is waiting for a path from the path queue.
+   *
+   * @return true if a path request of the Unit is pending, false otherwise.
+   */
+  bool isPathing() const;
+
   /**
    * @brief Returns the current health of the Unit.
    *
@@ -229,14 +366,14 @@ public:
    *
    * @return The type of the Unit.
    */
-  std::string getType() const;
+  UnitType getType() const;
 
   /**
    * @brief Sets the type of the Unit.
    *
    * @param newType The new type for the Unit.
    */
-  void setType(std::string newType);
+  void setType(UnitType newType);
 
   /**
    * @brief Returns the current force acting on the Unit.
@@ -253,11 +390,18 @@ public:
   void setForce(std::pair<float, float> f);
 
   /**
-   * @brief Handles the death of the Unit.
+   * @brief Handles the death of the Unit, its pending path request is cancelled.
    */
   void die();
 
 protected:
+  /**
+   * @brief Sets the time between two calls of interact.
+   *
+   * @param interval The interval in milliseconds of game time.
+   */
+  void setInteractionInterval(uint32_t interval);
+
   /**
    * @brief Calculates the path to the target location.
    *
@@ -267,28 +411,46 @@ protected:
   void calculatePath(int targetX, int targetY);
 
   /**
-   * @brief Executes the next movement step for the Unit.
+   * @brief Replaces the current path with a path given in grid coordinates.
+   *
+   * The path is converted to pixel coordinates and its first tile (the tile the unit stands on) is dropped.
+   *
+   * @param gridPath The corners of the path in grid coordinates, starting with the tile of the unit.
    */
-  void nextStep();
+  void setGridPath(const WaypointBuffer &gridPath);
 
-  std::string type;
+  /**
+   * @brief Cancels the pending path request of the Unit, if there is one.
+   */
+  void cancelPathRequest();
 
-  std::pair<float, float> force;
+  /**
+   * @brief Searches the path to the next abstract waypoint once the current path is used up.
+   */
+  void refineNextWaypoint();
 
-  int health;
-  int maxHealth;
-  float speed;
-  int ownerId;
-  float radius;
+  /**
+   * @brief Executes the next movement step for the Unit.
+   */
+  void nextStep();
 
-  float actualX, actualY;
-  std::list<std::pair<int, int>> path;
+  UnitStore &store;
+  int slot;
   std::vector<std::unique_ptr<Unit>> &allUnits;
-  std::vector<Unit *> &unitsToRemove;
+  std::vector<UnitHandle> &unitsToRemove;
   std::vector<std::unique_ptr<Wall>> &allWalls;
   std::vector<std::unique_ptr<Resource>> &allResources;
   std::vector<Castle *> &allCastles;
-  uint32_t lastInteraction;
+
+private:
+  friend class UnitStore;
+
+  /**
+   * @brief Updates the slot of the unit after the store moved it.
+   *
+   * @param newSlot The new slot of the unit.
+   */
+  void setSlot(int newSlot);
 };
 
 #endif
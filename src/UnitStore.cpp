@@ -0,0 +1,397 @@
+#include "UnitStore.h"
+#include "Game.h"
+#include "Unit.h"
+#include "Map.h"
+#include "SpatialGrid.h"
+#include "CollisionMap.h"
+#include "ThreadPool.h"
+#include "utils.h"
+#include "Profiler.h"
+#include <cmath>
+
+int UnitStore::add(Unit *unit, const SDL_Rect &rect, UnitType type, int health, float speed, int ownerId, float radius, uint32_t interactionInterval)
+{
+  units.push_back(unit);
+  rects.push_back(rect);
+  x.push_back(rect.x);
+  y.push_back(rect.y);
+  previousPositions.push_back({rect.x, rect.y});
+  forceX.push_back(0.0f);
+  forceY.push_back(0.0f);
+  this->health.push_back(health);
+  maxHealth.push_back(health);
+  this->speed.push_back(speed);
+  this->radius.push_back(radius);
+  owners.push_back(ownerId);
+  types.push_back(type);
+  lastInteractions.push_back(0);
+  interactionIntervals.push_back(interactionInterval);
+  pathTickets.push_back(0);
+  paths.emplace_back();
+  waypoints.emplace_back();
+  steerX.push_back(0.0f);
+  steerY.push_back(0.0f);
+
+  // Reuse the handle table entry of a removed unit, its generation was already increased
+  uint32_t id;
+  if (!freeIds.empty())
+  {
+    id = freeIds.back();
+    freeIds.pop_back();
+  }
+  else
+  {
+    id = static_cast<uint32_t>(generations.size());
+    generations.push_back(1);
+    slots.push_back(0);
+  }
+  int slot = static_cast<int>(units.size()) - 1;
+  ids.push_back(id);
+  slots[id] = slot;
+  return slot;
+}
+
+void UnitStore::remove(int slot)
+{
+  // Invalidate all handles to the unit, 0 is skipped when the generation wraps around
+  uint32_t id = ids[slot];
+  if (++generations[id] == 0)
+    generations[id] = 1;
+  freeIds.push_back(id);
+
+  int last = static_cast<int>(units.size()) - 1;
+  if (slot != last)
+  {
+    units[slot] = units[last];
+    rects[slot] = rects[last];
+    x[slot] = x[last];
+    y[slot] = y[last];
+    previousPositions[slot] = previousPositions[last];
+    forceX[slot] = forceX[last];
+    forceY[slot] = forceY[last];
+    health[slot] = health[last];
+    maxHealth[slot] = maxHealth[last];
+    speed[slot] = speed[last];
+    radius[slot] = radius[last];
+    owners[slot] = owners[last];
+    types[slot] = types[last];
+    lastInteractions[slot] = lastInteractions[last];
+    interactionIntervals[slot] = interactionIntervals[last];
+    pathTickets[slot] = pathTickets[last];
+    std::swap(paths[slot], paths[last]);
+    std::swap(waypoints[slot], waypoints[last]);
+    steerX[slot] = steerX[last];
+    steerY[slot] = steerY[last];
+    ids[slot] = ids[last];
+    slots[ids[slot]] = slot;
+    units[slot]->setSlot(slot);
+  }
+
+  units.pop_back();
+  rects.pop_back();
+  x.pop_back();
+  y.pop_back();
+  previousPositions.pop_back();
+  forceX.pop_back();
+  forceY.pop_back();
+  health.pop_back();
+  maxHealth.pop_back();
+  speed.pop_back();
+  radius.pop_back();
+  owners.pop_back();
+  types.pop_back();
+  lastInteractions.pop_back();
+  interactionIntervals.pop_back();
+  pathTickets.pop_back();
+  paths.pop_back();
+  waypoints.pop_back();
+  steerX.pop_back();
+  steerY.pop_back();
+  ids.pop_back();
+}
+
+void UnitStore::savePreviousPositions()
+{
+  for (size_t slot = 0; slot < rects.size(); ++slot)
+  {
+    previousPositions[slot] = {rects[slot].x, rects[slot].y};
+  }
+}
+
+void UnitStore::followPaths(ThreadPool &pool)
+{
+  // Refining searches the path finder of the map, which is not thread safe. Afterwards no unit in the loop needs it.
+  for (size_t slot = 0; slot < units.size(); ++slot)
+  {
+    if (forceX[slot] == 0.0f && forceY[slot] == 0.0f && paths[slot].empty() && !waypoints[slot].empty())
+    {
+      refineNextWaypoint(slot);
+    }
+  }
+
+  pool.parallelFor(units.size(), [this](size_t, size_t begin, size_t end)
+                   {
+                     for (size_t slot = begin; slot < end; ++slot)
+                       followPath(slot);
+                   });
+}
+
+void UnitStore::separateAll(const SpatialGrid &grid, ThreadPool &pool)
+{
+  PROFILE_SCOPE("UnitStore::separateAll");
+  pool.parallelFor(units.size(), [this, &grid](size_t, size_t begin, size_t end)
+                   {
+                     for (size_t slot = begin; slot < end; ++slot)
+                       separateFromNeighbours(slot, grid);
+                   });
+}
+
+void UnitStore::applyForces(ThreadPool &pool)
+{
+  pool.parallelFor(units.size(), [this](size_t, size_t begin, size_t end)
+                   {
+                     for (size_t slot = begin; slot < end; ++slot)
+                     {
+                       if (forceX[slot] != 0.0f || forceY[slot] != 0.0f)
+                         applyForce(slot);
+                     }
+                   });
+}
+
+void UnitStore::interactAll(uint32_t now, ThreadPool &pool)
+{
+  PROFILE_SCOPE("UnitStore::interactAll");
+  intents.resize(pool.getMaxChunks());
+  for (auto &chunkIntents : intents)
+    chunkIntents.clear();
+
+  // Read phase: the timers are checked here, units that act plan what they do without changing anything else
+  pool.parallelFor(units.size(), [this, now](size_t chunk, size_t begin, size_t end)
+                   {
+                     for (size_t slot = begin; slot < end; ++slot)
+                     {
+                       if (Game::ticksToMilliseconds(now - lastInteractions[slot]) < interactionIntervals[slot])
+                         continue;
+
+                       lastInteractions[slot] = now;
+                       uint64_t random = randomStream(now, ids[slot]);
+                       UnitIntent intent;
+                       if (units[slot]->planInteraction(random, intent))
+                         intents[chunk].push_back(intent);
+                     }
+                   });
+
+  // Commit phase: the chunks hold consecutive slots, so the actions are carried out in slot order
+  for (const auto &chunkIntents : intents)
+  {
+    for (const UnitIntent &intent : chunkIntents)
+      units[intent.slot]->applyInteraction(intent);
+  }
+}
+
+void UnitStore::followPath(int slot)
+{
+  // If unit is under influence of a force, don't execute the path following behavior
+  if (forceX[slot] != 0.0f || forceY[slot] != 0.0f)
+    return;
+
+  WaypointBuffer &path = paths[slot];
+  if (path.empty() && !waypoints[slot].empty())
+  {
+    refineNextWaypoint(slot);
+  }
+
+  if (!path.empty())
+  {
+    auto next = path.front();
+
+    float nextX = next.first;
+    float nextY = next.second;
+
+    // The direction only changes at corners or after the unit was pushed off its line
+    if (steerX[slot] == 0.0f && steerY[slot] == 0.0f)
+    {
+      float dx = nextX - x[slot];
+      float dy = nextY - y[slot];
+      float magnitude = std::sqrt(dx * dx + dy * dy);
+      if (magnitude > 0.0f)
+      {
+        steerX[slot] = dx / magnitude;
+        steerY[slot] = dy / magnitude;
+      }
+    }
+
+    // Move the unit
+    x[slot] += steerX[slot] * speed[slot];
+    y[slot] += steerY[slot] * speed[slot];
+
+    SDL_Rect &rect = rects[slot];
+    rect.x = (int)x[slot];
+    rect.y = (int)y[slot];
+
+    // Check if we reached the corner, the path goes straight on to the next one
+    if (std::abs(x[slot] - nextX) < speed[slot] && std::abs(y[slot] - nextY) < speed[slot])
+    {
+      path.popFront();
+      resetSteering(slot);
+      if (path.empty() && waypoints[slot].empty())
+      {
+        if (rect.x % 16 != 0)
+        {
+          rect.x += 16 - (rect.x % 16);
+          x[slot] += speed[slot];
+        }
+        if ((rect.y - 88) % 16 != 0)
+        {
+          rect.y += 16 - ((rect.y - 88) % 16);
+          y[slot] += speed[slot];
+        }
+      }
+    }
+  }
+}
+
+void UnitStore::separateFromNeighbours(int slot, const SpatialGrid &grid)
+{
+  // Units moved since the grid was built this update, look a bit further than the unit itself
+  thread_local std::vector<int> nearbyUnits;
+  const SDL_Rect &rect = rects[slot];
+  SDL_Rect area = {rect.x - 8, rect.y - 8, rect.w + 16, rect.h + 16};
+  grid.query(area, nearbyUnits);
+
+  for (int other : nearbyUnits)
+  {
+    // Both units of a pair push themselves away from the other one
+    if (other == slot || other >= static_cast<int>(units.size()))
+      continue;
+
+    if (SDL_HasIntersection(&rect, &rects[other]))
+    {
+      separate(slot, other);
+    }
+  }
+}
+
+void UnitStore::separate(int slot, int other)
+{
+  // Separate units based on their centers and their size
+  float dx = rects[other].x - rects[slot].x;
+  float dy = rects[other].y - rects[slot].y;
+  float distance = std::sqrt(dx * dx + dy * dy);
+
+  float size1 = rects[slot].w / 2.0;
+  float size2 = rects[other].w / 2.0;
+
+  float overlap = (size1 + size2) - distance;
+
+  // Normalize
+  if (distance > 0)
+  {
+    dx /= distance;
+    dy /= distance;
+  }
+
+  // The rolls of the pair only depend on the two units, not on the order the units are separated in
+  uint64_t random = randomStream(Game::tick, ids[slot], ids[other]);
+
+  // Add some randomness to the direction of the force
+  int randomAngle = randomInt(random, -30, 30);           // This will give us a random angle between -30 and 30 degrees
+  float randomAngleRadians = randomAngle * M_PI / 180.0f; // Convert to radians
+  float newDx = dx * cos(randomAngleRadians) - dy * sin(randomAngleRadians);
+  float newDy = dx * sin(randomAngleRadians) + dy * cos(randomAngleRadians);
+
+  // Apply a unique force to the unit
+  float randomFactor = randomInt(random, 50, 300) / 100.0f;
+
+  forceX[slot] -= overlap * randomFactor * newDx;
+  forceY[slot] -= overlap * randomFactor * newDy;
+
+  float stationaryResistance = 0.8;
+  bool moving = isMoving(slot);
+  bool otherMoving = isMoving(other);
+
+  // Moving units walk through units standing in their way, which are pushed aside
+  if (moving && !otherMoving)
+  {
+    forceX[slot] = 0;
+    forceY[slot] = 0;
+  }
+
+  if (otherMoving && !moving && randomFactor > 2)
+  {
+    forceX[slot] *= stationaryResistance;
+    forceY[slot] *= stationaryResistance;
+  }
+}
+
+void UnitStore::applyForce(int slot)
+{
+  // Test the position the force would move the unit to, without moving it
+  float nextX = x[slot] + forceX[slot] * 0.05;
+  float nextY = y[slot] + forceY[slot] * 0.05;
+
+  if (collidesAt(slot, nextX, nextY))
+  {
+    // invert force direction if collision would occur
+    forceX[slot] = -forceX[slot];
+    forceY[slot] = -forceY[slot];
+
+    nextX = x[slot] + forceX[slot] * 0.05;
+    nextY = y[slot] + forceY[slot] * 0.05;
+  }
+
+  x[slot] = nextX;
+  y[slot] = nextY;
+  rects[slot].x = (int)nextX;
+  rects[slot].y = (int)nextY;
+  resetSteering(slot);
+
+  forceX[slot] -= forceX[slot] * 0.05;
+  forceY[slot] -= forceY[slot] * 0.05;
+
+  if (std::abs(forceX[slot]) < 0.1 && std::abs(forceY[slot]) < 0.1)
+  {
+    forceX[slot] = 0.0f;
+    forceY[slot] = 0.0f;
+  }
+}
+
+bool UnitStore::collidesAt(int slot, float x, float y) const
+{
+  SDL_Rect movedRect = {(int)x, (int)y, rects[slot].w, rects[slot].h};
+  return LevelScene::getCollisionMap().collides(movedRect);
+}
+
+void UnitStore::setGridPath(int slot, const WaypointBuffer &gridPath)
+{
+  // Convert grid indexes to pixel coordinates for movement, the first corner is the tile the unit stands on
+  WaypointBuffer &path = paths[slot];
+  path.clear();
+  resetSteering(slot);
+  for (size_t i = 1; i < gridPath.size(); ++i)
+  {
+    int pixelX = gridPath[i].first * 16;
+    int pixelY = gridPath[i].second * 16 + 88; // account for offset of game area
+    path.pushBack(std::make_pair(pixelX, pixelY));
+  }
+}
+
+void UnitStore::refineNextWaypoint(int slot)
+{
+  int gridStartX = x[slot] / 16;
+  int gridStartY = (y[slot] - 88) / 16;
+  thread_local WaypointBuffer gridPath;
+
+  // Waypoints are at most a cluster apart, these searches stay small even on big maps
+  while (paths[slot].empty() && !waypoints[slot].empty())
+  {
+    LevelScene::getMap().calculatePath(std::make_pair(gridStartX, gridStartY), waypoints[slot].front(), gridPath);
+    waypoints[slot].popFront();
+
+    if (gridPath.empty())
+    {
+      waypoints[slot].clear();
+    }
+    setGridPath(slot, gridPath);
+  }
+}
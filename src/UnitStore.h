@@ -0,0 +1,272 @@
+#ifndef UNITSTORE_H
+#define UNITSTORE_H
+
+#include "UnitTypes.h"
+#include "WaypointBuffer.h"
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class Unit;
+class SpatialGrid;
+class ThreadPool;
+
+/**
+ * @struct UnitHandle
+ * @brief A reference to a unit that can be checked for validity.
+ *
+ * The index names an entry of the handle table of the store, which follows the unit when its slot moves. The
+ * generation of the entry is increased when the unit is removed, so handles to a removed unit stay detectably stale even
+ * after the entry is reused. A default constructed handle refers to no unit.
+ */
+struct UnitHandle
+{
+  uint32_t index = 0;      /**< The entry in the handle table. */
+  uint32_t generation = 0; /**< The generation of the entry when the handle was made, never 0 for a valid handle. */
+
+  bool operator==(const UnitHandle &other) const { return index == other.index && generation == other.generation; }
+  bool operator!=(const UnitHandle &other) const { return !(*this == other); }
+};
+
+/**
+ * @struct UnitIntent
+ * @brief An action a unit decided on in the read phase of a tick, carried out in the commit phase.
+ */
+struct UnitIntent
+{
+  /**
+   * @enum Kind
+   * @brief The kinds of actions.
+   */
+  enum Kind : uint8_t
+  {
+    ATTACK_UNIT,   /**< Damage the unit in the target slot. */
+    ATTACK_CASTLE, /**< Damage the castle with the target index. */
+    GATHER         /**< Gather from the resource with the target index. */
+  };
+
+  Kind kind;  /**< What the unit does. */
+  int slot;   /**< The slot of the acting unit. */
+  int target; /**< The slot of the attacked unit, or the index of the attacked castle or the gathered resource. */
+  int amount; /**< The damage dealt or the amount gathered. */
+};
+
+/**
+ * @class UnitStore
+ * @brief Storage of the simulation state of all units as parallel arrays.
+ *
+ * Every unit owns one slot, the same index in every column. The update kernels (movement, separation, forces and the
+ * interaction timers) walk the columns they need from front to back instead of visiting every unit object on the
+ * heap. Unit objects are thin handles that read and write their slot.
+ *
+ * Units are removed with swap and pop: the last slot is moved into the freed one and its unit is told its new slot.
+ * Slot indexes are therefore only stable while no unit is removed, which the level does after the update. Anything
+ * that keeps a unit across ticks (selections, removal lists, path requests) holds a UnitHandle instead, which is
+ * resolved and validated in constant time.
+ *
+ * The kernels run on a thread pool. In every parallel step a unit only writes its own slot: separation gathers the
+ * push from all neighbours instead of pushing both units of a pair, and interactions are only planned as UnitIntents,
+ * which are carried out afterwards on the calling thread in slot order. Random rolls come from streams keyed by the
+ * tick and the handle index, so a tick gives the same result with any number of threads.
+ */
+class UnitStore
+{
+public:
+  /**
+   * @brief Adds a unit and initializes its slot.
+   *
+   * @param unit The unit the slot belongs to.
+   * @param rect The rectangle of the unit in pixels.
+   * @param type The kind of the unit.
+   * @param health The initial and maximum health of the unit.
+   * @param speed The distance the unit walks per tick in pixels.
+   * @param ownerId The ID of the owner of the unit.
+   * @param radius The interaction radius of the unit in tiles.
+   * @param interactionInterval The time between two attacks or gatherings in milliseconds.
+   * @return int The slot of the unit.
+   */
+  int add(Unit *unit, const SDL_Rect &rect, UnitType type, int health, float speed, int ownerId, float radius, uint32_t interactionInterval);
+
+  /**
+   * @brief Removes the slot of a unit, the last slot takes its place.
+   *
+   * @param slot The slot to remove.
+   */
+  void remove(int slot);
+
+  /**
+   * @brief Returns the handle of the unit in a slot.
+   *
+   * @param slot The slot of the unit.
+   * @return UnitHandle The handle, valid until the unit is removed.
+   */
+  UnitHandle handleOf(int slot) const { return {ids[slot], generations[ids[slot]]}; }
+
+  /**
+   * @brief Checks whether a handle still refers to a unit.
+   *
+   * @param handle The handle to check.
+   * @return bool True if the unit of the handle has not been removed, false otherwise.
+   */
+  bool isValid(UnitHandle handle) const { return handle.index < generations.size() && generations[handle.index] == handle.generation; }
+
+  /**
+   * @brief Resolves a handle.
+   *
+   * @param handle The handle to resolve.
+   * @return Unit* The unit of the handle, nullptr if it has been removed.
+   */
+  Unit *get(UnitHandle handle) const { return isValid(handle) ? units[slots[handle.index]] : nullptr; }
+
+  /**
+   * @brief Returns the number of units.
+   *
+   * @return size_t The number of occupied slots.
+   */
+  size_t size() const { return units.size(); }
+
+  /**
+   * @brief Remembers the position of every unit as the start of the next tick, rendering interpolates from it.
+   */
+  void savePreviousPositions();
+
+  /**
+   * @brief Moves every unit one step along its path.
+   *
+   * Waypoints are refined on the calling thread first, they search the shared path finder of the map.
+   *
+   * @param pool The pool the units are moved on.
+   */
+  void followPaths(ThreadPool &pool);
+
+  /**
+   * @brief Pushes apart all overlapping units.
+   *
+   * @param grid Spatial grid built from the rects column, its indexes are slots.
+   * @param pool The pool the forces are gathered on.
+   */
+  void separateAll(const SpatialGrid &grid, ThreadPool &pool);
+
+  /**
+   * @brief Moves every unit pushed by a force.
+   *
+   * @param pool The pool the units are moved on.
+   */
+  void applyForces(ThreadPool &pool);
+
+  /**
+   * @brief Lets every unit whose interaction timer expired attack or gather.
+   *
+   * The actions are planned in parallel into a buffer per chunk and carried out in slot order afterwards.
+   *
+   * @param now The current tick.
+   * @param pool The pool the actions are planned on.
+   */
+  void interactAll(uint32_t now, ThreadPool &pool);
+
+  /**
+   * @brief Moves a unit one step along its path, refining the next waypoint when the path is used up.
+   *
+   * Units pushed by a force don't follow their path until the force has faded.
+   *
+   * @param slot The slot of the unit.
+   */
+  void followPath(int slot);
+
+  /**
+   * @brief Pushes a unit away from the units it overlaps, only the force of the unit itself is changed.
+   *
+   * @param slot The slot of the unit.
+   * @param grid Spatial grid built from the rects column, its indexes are slots.
+   */
+  void separateFromNeighbours(int slot, const SpatialGrid &grid);
+
+  /**
+   * @brief Adds a randomly deflected force pushing a unit away from a unit it overlaps.
+   *
+   * @param slot The slot of the pushed unit.
+   * @param other The slot of the overlapping unit.
+   */
+  void separate(int slot, int other);
+
+  /**
+   * @brief Moves a unit by its force, bouncing off static objects, and lets the force fade.
+   *
+   * @param slot The slot of the unit.
+   */
+  void applyForce(int slot);
+
+  /**
+   * @brief Checks whether a unit would collide with a static object at a position.
+   *
+   * @param slot The slot of the unit.
+   * @param x The x-coordinate of the position in pixels.
+   * @param y The y-coordinate of the position in pixels.
+   * @return bool True if the unit would collide, false otherwise.
+   */
+  bool collidesAt(int slot, float x, float y) const;
+
+  /**
+   * @brief Checks whether a unit has somewhere to go.
+   *
+   * @param slot The slot of the unit.
+   * @return bool True if the unit has a path, waypoints or a pending path request.
+   */
+  bool isMoving(int slot) const { return !paths[slot].empty() || !waypoints[slot].empty() || pathTickets[slot] != 0; }
+
+  /**
+   * @brief Makes a unit work out the direction to its next corner again, after it was moved off its line.
+   *
+   * @param slot The slot of the unit.
+   */
+  void resetSteering(int slot)
+  {
+    steerX[slot] = 0.0f;
+    steerY[slot] = 0.0f;
+  }
+
+  /**
+   * @brief Replaces the path of a unit with a path given in grid coordinates.
+   *
+   * The path is converted to pixel coordinates and its first tile (the tile the unit stands on) is dropped.
+   *
+   * @param slot The slot of the unit.
+   * @param gridPath The corners of the path in grid coordinates, starting with the tile of the unit.
+   */
+  void setGridPath(int slot, const WaypointBuffer &gridPath);
+
+  /**
+   * @brief Searches the path to the next abstract waypoint of a unit once its current path is used up.
+   *
+   * @param slot The slot of the unit.
+   */
+  void refineNextWaypoint(int slot);
+
+  std::vector<Unit *> units;                  /**< The unit of every slot. */
+  std::vector<SDL_Rect> rects;                /**< Rectangle in whole pixels, for collisions, queries and rendering. */
+  std::vector<float> x, y;                    /**< Exact position in pixels. */
+  std::vector<SDL_Point> previousPositions;   /**< Rectangle position at the start of the tick. */
+  std::vector<float> forceX, forceY;          /**< Separation force acting on the unit. */
+  std::vector<int> health, maxHealth;         /**< Current and maximum health. */
+  std::vector<float> speed;                   /**< Walking distance per tick in pixels. */
+  std::vector<float> radius;                  /**< Interaction radius in tiles. */
+  std::vector<int> owners;                    /**< ID of the owning player. */
+  std::vector<UnitType> types;                /**< Kind of the unit. */
+  std::vector<uint32_t> lastInteractions;     /**< Tick of the last attack or gathering. */
+  std::vector<uint32_t> interactionIntervals; /**< Time between attacks or gatherings in milliseconds. */
+  std::vector<uint32_t> pathTickets;          /**< Pending path request, 0 if there is none. */
+  std::vector<WaypointBuffer> paths;          /**< Pixel positions of the corners left to walk. */
+  std::vector<WaypointBuffer> waypoints;      /**< Abstract waypoints past the end of the path. */
+  std::vector<float> steerX, steerY;          /**< Direction to the next corner, (0, 0) until it is worked out. */
+  std::vector<uint32_t> ids;                  /**< Entry of the unit in the handle table. */
+
+private:
+  std::vector<std::vector<UnitIntent>> intents; /**< Actions planned by every chunk of the last interactAll. */
+  std::vector<int> slots;                       /**< Slot of the unit of every handle table entry. */
+  std::vector<uint32_t> generations;            /**< Current generation of every handle table entry, never 0. */
+  std::vector<uint32_t> freeIds;                /**< Handle table entries of removed units, reused by new units. */
+};
+
+#endif
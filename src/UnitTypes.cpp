@@ -0,0 +1,27 @@
+#include "UnitTypes.h"
+
+bool parseUnitType(const std::string &name, UnitType &type)
+{
+  for (uint8_t kind = 0; kind < sizeof(unitStats) / sizeof(unitStats[0]); ++kind)
+  {
+    if (name == unitStats[kind].name)
+    {
+      type = static_cast<UnitType>(kind);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parseResourceType(const std::string &name, ResourceType &type)
+{
+  for (uint8_t kind = 0; kind < sizeof(resourceStats) / sizeof(resourceStats[0]); ++kind)
+  {
+    if (name == resourceStats[kind].name)
+    {
+      type = static_cast<ResourceType>(kind);
+      return true;
+    }
+  }
+  return false;
+}
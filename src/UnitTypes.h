@@ -0,0 +1,132 @@
+#ifndef UNITTYPES_H
+#define UNITTYPES_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+ * @enum UnitType
+ * @brief The kinds of units.
+ */
+enum UnitType : uint8_t
+{
+  SOLDIER, /**< Fights enemy units and castles. */
+  WORKER   /**< Gathers wood and crystals from resources. */
+};
+
+/**
+ * @enum ResourceType
+ * @brief The kinds of resources.
+ */
+enum ResourceType : uint8_t
+{
+  WOOD,    /**< Gathered into the wood of the owner. */
+  CRYSTALS /**< Gathered into the crystals of the owner. */
+};
+
+/**
+ * @brief The number of owner colours, owners past the last colour reuse the colours from the start.
+ */
+constexpr int ownerColorCount = 6;
+
+/**
+ * @struct UnitStats
+ * @brief The base stats of a kind of unit, before talents are applied.
+ */
+struct UnitStats
+{
+  const char *name;                         /**< The name of the kind in saves. */
+  int health;                               /**< Health of a new unit. */
+  float speed;                              /**< Speed in pixels per second. */
+  float radius;                             /**< Radius in which the unit interacts with other objects. */
+  int width;                                /**< Width in pixels. */
+  int height;                               /**< Height in pixels. */
+  const char *textures[ownerColorCount][2]; /**< Regular and selected texture for every owner colour. */
+};
+
+/**
+ * @struct ResourceStats
+ * @brief The properties of a kind of resource.
+ */
+struct ResourceStats
+{
+  const char *name;    /**< The name of the kind in saves and maps. */
+  const char *texture; /**< The texture of the resource. */
+};
+
+/**
+ * @brief The stats of every kind of unit, indexed by UnitType.
+ */
+constexpr UnitStats unitStats[] = {
+    {"soldier", 60, 48.0f, 2.0f, 16, 16,
+     {{"./assets/blue_soldier.png", "./assets/blue_soldier_selected.png"},
+      {"./assets/red_soldier.png", "./assets/red_soldier_selected.png"},
+      {"./assets/green_soldier.png", "./assets/green_soldier_selected.png"},
+      {"./assets/yellow_soldier.png", "./assets/yellow_soldier_selected.png"},
+      {"./assets/purple_soldier.png", "./assets/purple_soldier_selected.png"},
+      {"./assets/orange_soldier.png", "./assets/orange_soldier_selected.png"}}},
+    {"worker", 40, 75.0f, 1.0f, 16, 16,
+     {{"./assets/blue_worker.png", "./assets/blue_worker_selected.png"},
+      {"./assets/red_worker.png", "./assets/red_worker_selected.png"},
+      {"./assets/green_worker.png", "./assets/green_worker_selected.png"},
+      {"./assets/yellow_worker.png", "./assets/yellow_worker_selected.png"},
+      {"./assets/purple_worker.png", "./assets/purple_worker_selected.png"},
+      {"./assets/orange_worker.png", "./assets/orange_worker_selected.png"}}}};
+
+/**
+ * @brief The properties of every kind of resource, indexed by ResourceType.
+ */
+constexpr ResourceStats resourceStats[] = {
+    {"wood", "./assets/wood_ore.png"},
+    {"crystals", "./assets/crystals_ore.png"}};
+
+/**
+ * @brief Returns the base stats of a kind of unit.
+ *
+ * @param type The kind of unit.
+ * @return const UnitStats& The stats of the kind.
+ */
+constexpr const UnitStats &getUnitStats(UnitType type) { return unitStats[type]; }
+
+/**
+ * @brief Returns the properties of a kind of resource.
+ *
+ * @param type The kind of resource.
+ * @return const ResourceStats& The properties of the kind.
+ */
+constexpr const ResourceStats &getResourceStats(ResourceType type) { return resourceStats[type]; }
+
+/**
+ * @brief Returns the textures of a unit.
+ *
+ * @param type The kind of the unit.
+ * @param ownerId The ID of the owner of the unit, which picks the colour.
+ * @return std::pair<const char *, const char *> The paths to the regular and selected texture.
+ */
+constexpr std::pair<const char *, const char *> getUnitTexturePath(UnitType type, int ownerId)
+{
+  const UnitStats &stats = getUnitStats(type);
+  int color = ownerId % ownerColorCount;
+  return {stats.textures[color][0], stats.textures[color][1]};
+}
+
+/**
+ * @brief Parses the name of a kind of unit, as written in saves.
+ *
+ * @param name The name to parse.
+ * @param type Set to the parsed kind on success.
+ * @return bool True if the name is a kind of unit, false otherwise.
+ */
+bool parseUnitType(const std::string &name, UnitType &type);
+
+/**
+ * @brief Parses the name of a kind of resource, as written in saves and maps.
+ *
+ * @param name The name to parse.
+ * @param type Set to the parsed kind on success.
+ * @return bool True if the name is a kind of resource, false otherwise.
+ */
+bool parseResourceType(const std::string &name, ResourceType &type);
+
+#endif
@@ -0,0 +1,115 @@
+#include "WaypointBuffer.h"
+
+WaypointBuffer::WaypointBuffer() : capacity(inlineCapacity), head(0), count(0) {}
+
+WaypointBuffer::WaypointBuffer(const WaypointBuffer &other) : WaypointBuffer()
+{
+  *this = other;
+}
+
+WaypointBuffer::WaypointBuffer(WaypointBuffer &&other) noexcept : WaypointBuffer()
+{
+  *this = std::move(other);
+}
+
+WaypointBuffer &WaypointBuffer::operator=(const WaypointBuffer &other)
+{
+  if (this == &other)
+    return *this;
+
+  clear();
+  reserve(other.count);
+  Point *target = points();
+  for (uint32_t i = 0; i < other.count; ++i)
+  {
+    target[i] = other[i];
+  }
+  count = other.count;
+  return *this;
+}
+
+WaypointBuffer &WaypointBuffer::operator=(WaypointBuffer &&other) noexcept
+{
+  if (this == &other)
+    return *this;
+
+  if (!other.heapPoints)
+  {
+    // Inline points can't be taken over, they fit into this buffer without allocating
+    Point *target = heapPoints ? heapPoints.get() : inlinePoints;
+    for (uint32_t i = 0; i < other.count; ++i)
+    {
+      target[i] = other[i];
+    }
+    head = 0;
+    count = other.count;
+  }
+  else
+  {
+    heapPoints = std::move(other.heapPoints);
+    capacity = other.capacity;
+    head = other.head;
+    count = other.count;
+    other.capacity = inlineCapacity;
+  }
+
+  other.clear();
+  return *this;
+}
+
+void WaypointBuffer::pushBack(Point point)
+{
+  if (count == capacity)
+  {
+    reserve(capacity * 2);
+  }
+  points()[(head + count) & (capacity - 1)] = point;
+  ++count;
+}
+
+void WaypointBuffer::pushCorner(Point point)
+{
+  if (count > 0 && back() == point)
+    return;
+
+  if (count >= 2)
+  {
+    const Point &previous = (*this)[count - 2];
+    const Point &last = back();
+    int firstX = last.first - previous.first;
+    int firstY = last.second - previous.second;
+    int secondX = point.first - last.first;
+    int secondY = point.second - last.second;
+
+    // Same line and same direction, the last point is no corner
+    if (firstX * secondY == firstY * secondX && firstX * secondX + firstY * secondY > 0)
+    {
+      points()[(head + count - 1) & (capacity - 1)] = point;
+      return;
+    }
+  }
+
+  pushBack(point);
+}
+
+void WaypointBuffer::reserve(size_t minimumCapacity)
+{
+  if (minimumCapacity <= capacity)
+    return;
+
+  uint32_t newCapacity = capacity;
+  while (newCapacity < minimumCapacity)
+  {
+    newCapacity *= 2;
+  }
+
+  std::unique_ptr<Point[]> newPoints(new Point[newCapacity]);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    newPoints[i] = (*this)[i];
+  }
+
+  heapPoints = std::move(newPoints);
+  capacity = newCapacity;
+  head = 0;
+}
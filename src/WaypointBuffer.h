@@ -0,0 +1,126 @@
+#ifndef WAYPOINTBUFFER_H
+#define WAYPOINTBUFFER_H
+
+#include <utility>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class WaypointBuffer
+ * @brief Ring buffer of the points of a path, walked from the front.
+ *
+ * Short paths fit into the buffer itself, so a unit's path lives next to the paths of the other units in the unit store
+ * instead of in list nodes scattered over the heap. Longer paths move to a heap buffer that is kept when the buffer is
+ * cleared, so a unit allocates at most a few times over its life however often it gets a new path.
+ *
+ * Paths are stored as their corners only: pushCorner merges a point into the previous one when both continue in the same
+ * direction, so a straight corridor costs one point however long it is.
+ */
+class WaypointBuffer
+{
+public:
+  using Point = std::pair<int, int>;
+
+  /**
+   * @brief Constructs an empty buffer.
+   */
+  WaypointBuffer();
+
+  WaypointBuffer(const WaypointBuffer &other);
+  WaypointBuffer(WaypointBuffer &&other) noexcept;
+  WaypointBuffer &operator=(const WaypointBuffer &other);
+  WaypointBuffer &operator=(WaypointBuffer &&other) noexcept;
+
+  /**
+   * @brief Checks whether there are no points left.
+   *
+   * @return bool True if the buffer is empty, false otherwise.
+   */
+  bool empty() const { return count == 0; }
+
+  /**
+   * @brief Returns the number of points left.
+   *
+   * @return size_t The number of points.
+   */
+  size_t size() const { return count; }
+
+  /**
+   * @brief Returns the first point.
+   *
+   * @return const Point& The point, the buffer must not be empty.
+   */
+  const Point &front() const { return points()[head]; }
+
+  /**
+   * @brief Returns the last point.
+   *
+   * @return const Point& The point, the buffer must not be empty.
+   */
+  const Point &back() const { return (*this)[count - 1]; }
+
+  /**
+   * @brief Returns a point counted from the front.
+   *
+   * @param index The position of the point, below size.
+   * @return const Point& The point.
+   */
+  const Point &operator[](size_t index) const { return points()[(head + index) & (capacity - 1)]; }
+
+  /**
+   * @brief Removes the first point.
+   */
+  void popFront()
+  {
+    head = (head + 1) & (capacity - 1);
+    --count;
+  }
+
+  /**
+   * @brief Removes all points, the memory of the buffer is kept.
+   */
+  void clear()
+  {
+    head = 0;
+    count = 0;
+  }
+
+  /**
+   * @brief Appends a point.
+   *
+   * @param point The point to append.
+   */
+  void pushBack(Point point);
+
+  /**
+   * @brief Appends a point of a path, dropping the previous point when it is not a corner.
+   *
+   * A point equal to the last one is ignored. If the last two points and the new one lie on a line in this order, the
+   * last point is moved to the new one instead of appending it.
+   *
+   * @param point The next point of the path.
+   */
+  void pushCorner(Point point);
+
+private:
+  static const uint32_t inlineCapacity = 8;
+
+  Point *points() { return heapPoints ? heapPoints.get() : inlinePoints; }
+  const Point *points() const { return heapPoints ? heapPoints.get() : inlinePoints; }
+
+  /**
+   * @brief Makes room for a number of points, the points keep their order and start at the front of the storage.
+   *
+   * @param minimumCapacity The number of points needed.
+   */
+  void reserve(size_t minimumCapacity);
+
+  Point inlinePoints[inlineCapacity];
+  std::unique_ptr<Point[]> heapPoints;
+  uint32_t capacity; /**< Always a power of two, so indexes wrap with a mask. */
+  uint32_t head;
+  uint32_t count;
+};
+
+#endif
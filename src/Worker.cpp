@@ -1,61 +1,59 @@
 #include "Worker.h"
+#include "LevelScene.h"
 #include "utils.h"
 
-Worker::Worker(int x, int y, int width, int height, std::string type, int health, float speed, uint32_t gatherRate, int &wood, int &crystals, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
-    : Unit(x, y, width, height, type, health, speed, ownerId, radius, allUnits, unitsToRemove, allWalls, allResources, allCastles), gatherRate(gatherRate), wood(wood), crystals(crystals) {}
-
-Worker::~Worker() = default;
-
-Worker *Worker::clone() const
+Worker::Worker(int x, int y, int width, int height, UnitType type, int health, float speed, uint32_t gatherRate, int &wood, int &crystals, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles)
+    : Unit(x, y, width, height, type, health, speed, ownerId, radius, allUnits, unitsToRemove, allWalls, allResources, allCastles), wood(wood), crystals(crystals)
 {
-  return new Worker(*this);
+  setInteractionInterval(gatherRate);
 }
 
-void Worker::update()
-{
-  nextStep();
-  handleCollisions();
+Worker::~Worker() = default;
 
-  if (force.first != 0.0f || force.second != 0.0f)
+bool Worker::planInteraction(uint64_t &random, UnitIntent &intent) const
+{
+  // Create a vector to hold the resources that are in range
+  thread_local std::vector<int> inRangeResources;
+  thread_local std::vector<int> nearbyResources;
+  inRangeResources.clear();
+  const SDL_Rect &rect = getRect();
+  int reach = getRadius() * 16 + 1;
+  SDL_Rect area = {rect.x + rect.w / 2 - reach, rect.y + rect.h / 2 - reach, 2 * reach, 2 * reach};
+  LevelScene::getResourceGrid().query(area, nearbyResources);
+
+  for (int index : nearbyResources)
   {
-    applyForce();
+    if (isInRange(*allResources[index]))
+    {
+      inRangeResources.push_back(index);
+    }
   }
 
-  uint32_t now = SDL_GetTicks();
-  uint32_t timeSinceLastInteraction = now - lastInteraction;
+  if (inRangeResources.empty())
+    return false;
 
-  if (timeSinceLastInteraction >= gatherRate)
-  {
-    // Reset the timer
-    lastInteraction = now;
-
-    // Create a vector to hold the resources that are in range
-    std::vector<Resource *> inRangeResources;
-    for (const auto &potentialResource : allResources)
-    {
-      if (isInRange(*potentialResource))
-      {
-        inRangeResources.push_back(potentialResource.get());
-      }
-    }
+  // Select a random resource from the inRangeResources vector
+  int randomIndex = randomInt(random, 0, inRangeResources.size() - 1);
+  intent.kind = UnitIntent::GATHER;
+  intent.slot = slot;
+  intent.target = inRangeResources[randomIndex];
+  intent.amount = randomInt(random, 1, 8);
+  return true;
+}
 
-    if (!inRangeResources.empty())
-    {
-      // Select a random resource from the inRangeResources vector
-      int randomIndex = randomInt(0, inRangeResources.size() - 1);
-      gatherResource(*inRangeResources[randomIndex]);
-    }
-  }
+void Worker::applyInteraction(const UnitIntent &intent)
+{
+  gatherResource(*allResources[intent.target], intent.amount);
 }
 
-void Worker::gatherResource(Resource &resource)
+void Worker::gatherResource(const Resource &resource, int amount)
 {
-  if (resource.getType() == "crystals")
+  if (resource.getType() == CRYSTALS)
   {
-    crystals += randomInt(1, 8);
+    crystals += amount;
   }
-  if (resource.getType() == "wood")
+  if (resource.getType() == WOOD)
   {
-    wood += randomInt(1, 8);
+    wood += amount;
   }
 }
\ No newline at end of file
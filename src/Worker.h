@@ -39,7 +39,7 @@ public:
    * @param allResources Reference to the vector of all resources in the game.
    * @param allCastles Reference to the vector of all castles in the game.
    */
-  Worker(int x, int y, int width, int height, std::string type, int health, float speed, uint32_t gatherRate, int &wood, int &crystals, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<Unit *> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
+  Worker(int x, int y, int width, int height, UnitType type, int health, float speed, uint32_t gatherRate, int &wood, int &crystals, int ownerId, float radius, std::vector<std::unique_ptr<Unit>> &allUnits, std::vector<UnitHandle> &unitsToRemove, std::vector<std::unique_ptr<Wall>> &allWalls, std::vector<std::unique_ptr<Resource>> &allResources, std::vector<Castle *> &allCastles);
 
   /**
    * @brief Destructor for the Worker class.
@@ -49,33 +49,34 @@ public:
   ~Worker();
 
   /**
-   * @brief Update the worker.
+   * @brief Picks a random resource in range and a random amount to gather, called once per gather interval.
    *
-   * This function updates the worker's position, handles collisions, applies forces,
-   * and gathers resources at the specified gather rate.
+   * @param random The random stream of the worker for this tick.
+   * @param intent Set to the gathering.
+   * @return true if a resource is in range, false otherwise.
    */
-  void update() override;
+  bool planInteraction(uint64_t &random, UnitIntent &intent) const override;
 
   /**
-   * @brief Creates a new Worker object that is an exact copy of this Worker.
+   * @brief Gathers from the resource picked by planInteraction.
    *
-   * @return Pointer to the cloned Worker object.
+   * @param intent The gathering.
    */
-  Worker *clone() const override;
+  void applyInteraction(const UnitIntent &intent) override;
 
   /**
    * @brief Gather a resource.
    *
    * This function allows the worker to gather a resource based on its type.
-   * If the resource is "crystals", the worker adds a random amount of crystals to its owners inventory.
-   * If the resource is "wood", the worker adds a random amount of wood to its owners inventory.
+   * If the resource is CRYSTALS, the worker adds the amount to the crystals of its owner.
+   * If the resource is WOOD, the worker adds the amount to the wood of its owner.
    *
    * @param resource The resource to gather.
+   * @param amount The amount to gather.
    */
-  void gatherResource(Resource &resource);
+  void gatherResource(const Resource &resource, int amount);
 
 private:
-  uint32_t gatherRate;
   int &wood;
   int &crystals;
 };
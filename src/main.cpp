@@ -1,9 +1,65 @@
 #include <iostream>
+#include <string>
 #include <SDL2/SDL.h>
 #include "Game.h"
+#include "utils.h"
+
+/**
+ * @brief Simulates one level without a window and prints how it ended.
+ *
+ * Usage: --headless <level file> [max ticks] [seed]
+ * The match runs until a side has lost or max ticks (default 10 minutes of game time) have passed.
+ *
+ * @return int EXIT_SUCCESS if the level was simulated, EXIT_FAILURE if the arguments or the level are invalid.
+ */
+int runHeadless(int argc, char *argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " --headless <level file> [max ticks] [seed]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string levelPath = argv[2];
+  uint32_t maxTicks = 10 * 60 * Game::ticksPerSecond;
+  try
+  {
+    if (argc > 3)
+      maxTicks = static_cast<uint32_t>(std::stoul(argv[3]));
+    if (argc > 4)
+      seedRandom(static_cast<unsigned int>(std::stoul(argv[4])));
+  }
+  catch (const std::exception &)
+  {
+    std::cerr << "Max ticks and seed have to be positive numbers." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Game game;
+  game.initHeadless();
+
+  std::unique_ptr<LevelScene> level = game.runHeadless(levelPath, maxTicks);
+  if (!level)
+  {
+    game.cleanup();
+    return EXIT_FAILURE;
+  }
+
+  const char *outcome = !level->isGameOver() ? "undecided" : level->hasPlayerWon() ? "won" : "lost";
+  printf("%s: %s after %u ticks (%u ms of game time)\n", levelPath.c_str(), outcome, Game::tick, Game::ticksToMilliseconds(Game::tick));
+
+  level.reset();
+  game.cleanup();
+  return EXIT_SUCCESS;
+}
 
 int main(int argc, char *argv[])
 {
+  if (argc > 1 && std::string(argv[1]) == "--headless")
+  {
+    return runHeadless(argc, argv);
+  }
+
   Game game;
 
   // Game init
@@ -16,4 +72,4 @@ int main(int argc, char *argv[])
   game.cleanup();
 
   return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
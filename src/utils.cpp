@@ -1,5 +1,6 @@
 #include "utils.h"
 #include "Game.h"
+#include "UnitTypes.h"
 #include <random>
 #include <fstream>
 #include <sstream>
@@ -23,12 +24,68 @@ SDL_Texture *loadTexture(const char *filename)
   return texture;
 }
 
+/**
+ * @brief Get the random number generator shared by the game.
+ *
+ * The generator is seeded from the system on first use, unless seedRandom was called before.
+ *
+ * @return std::mt19937& The shared generator.
+ */
+static std::mt19937 &randomEngine()
+{
+  static std::mt19937 mt(std::random_device{}());
+  return mt;
+}
+
 int randomInt(int min, int max)
 {
-  static std::random_device rd;
-  static std::mt19937 mt(rd());
   std::uniform_int_distribution<int> dist(min, max);
-  return dist(mt);
+  return dist(randomEngine());
+}
+
+/**
+ * @brief Get the seed the random streams are derived from.
+ *
+ * @return uint64_t& The seed, drawn from the system unless seedRandom was called.
+ */
+static uint64_t &streamSeed()
+{
+  static uint64_t seed = std::random_device{}();
+  return seed;
+}
+
+/**
+ * @brief Advance a SplitMix64 state and return its next output.
+ *
+ * @param state The state to advance.
+ * @return uint64_t The next 64 random bits.
+ */
+static uint64_t splitMix64(uint64_t &state)
+{
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+void seedRandom(unsigned int seed)
+{
+  randomEngine().seed(seed);
+  streamSeed() = seed;
+}
+
+uint64_t randomStream(uint32_t tick, uint32_t first, uint32_t second)
+{
+  uint64_t state = streamSeed() ^ (uint64_t(tick) << 32 | first);
+  state = splitMix64(state) ^ second;
+  splitMix64(state);
+  return state;
+}
+
+int randomInt(uint64_t &stream, int min, int max)
+{
+  uint64_t range = uint64_t(int64_t(max) - min) + 1;
+  return min + static_cast<int>(splitMix64(stream) % range);
 }
 
 int randomTileType()
@@ -156,6 +213,25 @@ void loadGameConfig(const std::string &filePath)
             return;
           }
         }
+        else if (section == "Display")
+        {
+          if (itemName == "mode" && itemValue == "vsync")
+            Game::presentMode = VSYNC;
+          else if (itemName == "mode" && itemValue == "limited")
+            Game::presentMode = LIMITED;
+          else if (itemName == "mode" && itemValue == "uncapped")
+            Game::presentMode = UNCAPPED;
+          else if (itemName == "fps" && itemValue.find_first_not_of("0123456789") == std::string::npos && itemValue.size() <= 4 && std::stoi(itemValue) > 0)
+            Game::frameRateCap = std::stoi(itemValue);
+          else if (itemName == "idle" && (itemValue == "on" || itemValue == "off"))
+            Game::idleInMenus = itemValue == "on";
+          else
+          {
+            printf("Error: invalid display setting: %s,%s\n", itemName.c_str(), itemValue.c_str());
+            Game::isRunning = false;
+            return;
+          }
+        }
       }
     }
 
@@ -168,32 +244,6 @@ void loadGameConfig(const std::string &filePath)
   }
 }
 
-std::pair<std::string, std::string> getSoldierTexturePath(int id)
-{
-  int index = id % 6;
-
-  switch (index)
-  {
-  case 0:
-    return {"./assets/blue_soldier.png", "./assets/blue_soldier_selected.png"};
-    break;
-  case 1:
-    return {"./assets/red_soldier.png", "./assets/red_soldier_selected.png"};
-    break;
-  case 2:
-    return {"./assets/green_soldier.png", "./assets/green_soldier_selected.png"};
-    break;
-  case 3:
-    return {"./assets/yellow_soldier.png", "./assets/yellow_soldier_selected.png"};
-    break;
-  case 4:
-    return {"./assets/purple_soldier.png", "./assets/purple_soldier_selected.png"};
-    break;
-  default:
-    return {"./assets/orange_soldier.png", "./assets/orange_soldier_selected.png"};
-  }
-}
-
 std::string getCastleTexturePath(int id)
 {
   int index = id % 6;
@@ -220,28 +270,21 @@ std::string getCastleTexturePath(int id)
   }
 }
 
-std::pair<std::string, std::string> getWorkerTexturePath(int id)
+std::vector<std::string> getLevelSpritePaths()
 {
-  int index = id % 6;
-
-  switch (index)
+  std::vector<std::string> paths = {"./assets/wall.png"};
+  for (const auto &stats : resourceStats)
   {
-  case 0:
-    return {"./assets/blue_worker.png", "./assets/blue_worker_selected.png"};
-    break;
-  case 1:
-    return {"./assets/red_worker.png", "./assets/red_worker_selected.png"};
-    break;
-  case 2:
-    return {"./assets/green_worker.png", "./assets/green_worker_selected.png"};
-    break;
-  case 3:
-    return {"./assets/yellow_worker.png", "./assets/yellow_worker_selected.png"};
-    break;
-  case 4:
-    return {"./assets/purple_worker.png", "./assets/purple_worker_selected.png"};
-    break;
-  default:
-    return {"./assets/orange_worker.png", "./assets/orange_worker_selected.png"};
+    paths.push_back(stats.texture);
+  }
+  for (int ownerId = 0; ownerId < ownerColorCount; ++ownerId)
+  {
+    paths.push_back(getCastleTexturePath(ownerId));
+    for (const auto &stats : unitStats)
+    {
+      paths.push_back(stats.textures[ownerId][0]);
+      paths.push_back(stats.textures[ownerId][1]);
+    }
   }
+  return paths;
 }
@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <cstdint>
 #include <utility>
 #include <string>
 #include <vector>
@@ -28,6 +29,38 @@ SDL_Texture *loadTexture(const char *filename);
  */
 int randomInt(int min, int max);
 
+/**
+ * @brief Seed the random number generator used by randomInt.
+ *
+ * Matches started with the same seed make the same random choices, which makes headless runs reproducible.
+ *
+ * @param seed The seed of the generator.
+ */
+void seedRandom(unsigned int seed);
+
+/**
+ * @brief Start a random stream that only depends on the seed of the game and the given keys.
+ *
+ * Simulation steps that run on several threads draw from their own streams instead of the shared generator, so what
+ * they roll does not depend on the order the threads run in.
+ *
+ * @param tick The tick the stream is used in.
+ * @param first The first key, usually the handle index of a unit.
+ * @param second The second key, 0 if not needed.
+ * @return uint64_t The state of the stream, to be passed to randomInt.
+ */
+uint64_t randomStream(uint32_t tick, uint32_t first, uint32_t second = 0);
+
+/**
+ * @brief Generate a random integer within a specified range from a random stream.
+ *
+ * @param stream The state of the stream, advanced by the call.
+ * @param min The minimum value of the range (inclusive).
+ * @param max The maximum value of the range (inclusive).
+ * @return int A random integer within the specified range.
+ */
+int randomInt(uint64_t &stream, int min, int max);
+
 /**
  * @brief Generate a random tile type.
  *
@@ -48,17 +81,6 @@ int randomTileType();
  */
 void loadGameConfig(const std::string &filePath);
 
-/**
- * @brief Get the paths to the textures for a soldier based on its ID.
- *
- * This function returns a pair of paths to the regular and selected textures for a soldier,
- * based on the soldier's ID. The ID is used to determine the texture variation.
- *
- * @param id The ID of the soldier.
- * @return std::pair<std::string, std::string> The paths to the soldier's regular and selected textures.
- */
-std::pair<std::string, std::string> getSoldierTexturePath(int id);
-
 /**
  * @brief Get the path to the texture for a castle based on its ID.
  *
@@ -71,14 +93,12 @@ std::pair<std::string, std::string> getSoldierTexturePath(int id);
 std::string getCastleTexturePath(int id);
 
 /**
- * @brief Get the paths to the textures for a worker based on its ID.
+ * @brief Returns the paths of all sprites drawn on the game area of a level.
  *
- * This function returns a pair of paths to the regular and selected textures for a worker,
- * based on the worker's ID. The ID is used to determine the texture variation.
+ * These are the walls, resources, castles and units of every colour, which are packed into the texture atlas.
  *
- * @param id The ID of the worker.
- * @return std::pair<std::string, std::string> The paths to the worker's regular and selected textures.
+ * @return std::vector<std::string> The paths of the sprite textures.
  */
-std::pair<std::string, std::string> getWorkerTexturePath(int id);
+std::vector<std::string> getLevelSpritePaths();
 
 #endif
\ No newline at end of file